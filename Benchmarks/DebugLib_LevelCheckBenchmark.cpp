@@ -0,0 +1,77 @@
+/**
+*	DESCRIPTION:
+*		Measures the cost of a message suppressed by the global log level.
+*		Compares the inlined relaxed level check of start message macros with an out-of-line
+*		sequentially consistent load, which is how the level was checked before.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+**/
+/// STD
+#include <cstdio>
+#include <chrono>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+
+#if defined(_MSC_VER)
+#	define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#	define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+// Count of messages in one measurement
+#define BENCHMARK_ITERATIONS 100000000ull
+// Count of measurements : the best one is reported
+#define BENCHMARK_REPEATS 5
+
+namespace
+{
+	BENCHMARK_NOINLINE ::DebugLib::Level outOfLineLogLevel()
+	{
+		return static_cast<::DebugLib::Level>(::DebugLib::DEBUG_LIB_LOG_LEVEL_VAR_NAME.value.load());
+	}
+
+	BENCHMARK_NOINLINE void inlineCheck(unsigned long long iterations)
+	{
+		for (unsigned long long i = 0; i < iterations; ++i)
+			DEBUG_INFO_MESSAGE
+				DEBUG_PRINT("\tINFO message ", i);
+			DEBUG_END_MESSAGE
+	}
+
+	BENCHMARK_NOINLINE void outOfLineCheck(unsigned long long iterations)
+	{
+		for (unsigned long long i = 0; i < iterations; ++i)
+			if (outOfLineLogLevel() <= ::DebugLib::Level::Info)
+			{
+				DEBUG_LIB_MESSAGE_OPEN(::DebugLib::Level::Info, "INFO::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__))
+				DEBUG_PRINT("\tINFO message ", i);
+				DEBUG_LIB_MESSAGE_CLOSE
+			}
+	}
+
+	template < typename Function >
+	double measure(Function function)
+	{
+		double best = 0.0;
+		for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+		{
+			const auto start = ::std::chrono::steady_clock::now();
+			function(BENCHMARK_ITERATIONS);
+			const auto stop = ::std::chrono::steady_clock::now();
+			const double ns = ::std::chrono::duration<double, ::std::nano>(stop - start).count() / BENCHMARK_ITERATIONS;
+			if (!repeat || ns < best)
+				best = ns;
+		}
+		return best;
+	}
+}
+
+int main()
+{
+	::DebugLib::SetGlobalLogLevel(::DebugLib::Level::Nothing);
+	::std::printf("Suppressed message, inline relaxed check : %.3f ns\n", measure(inlineCheck));
+	::std::printf("Suppressed message, out-of-line seq_cst  : %.3f ns\n", measure(outOfLineCheck));
+	return 0;
+}
@@ -0,0 +1,139 @@
+/**
+*	DESCRIPTION:
+*		Measures the cost of messages suppressed by the global log level in hot code: a leaf function
+*		and an inner loop are compared with the same code without the message.
+*		Functions with C linkage are also inspected in assembly by the suppressed_path_check target
+*		of Makefile: their path up to the first return must have no calls, as the message body is
+*		kept off the hot path (See: DEBUG_LIB_COLD_BEGIN).
+*		Results are printed and appended to DebugLib_Benchmark_Results.jsonl as JSON lines.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+**/
+/// STD
+#include <cstdio>
+#include <ctime>
+#include <chrono>
+#include <vector>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+
+#if defined(_MSC_VER)
+#	define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#	define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+// Count of calls or loop iterations in one measurement
+#define BENCHMARK_ITERATIONS 100000000ull
+// Count of values processed by one call of loop functions
+#define BENCHMARK_LOOP_SIZE 1024
+// Count of measurements : the best one is reported
+#define BENCHMARK_REPEATS 5
+
+extern "C"
+{
+	BENCHMARK_NOINLINE int suppressedLeaf(int value)
+	{
+		DEBUG_INFO_MESSAGE
+			DEBUG_PRINT("\tvalue ", value);
+		DEBUG_END_MESSAGE
+		return value * 3 + 1;
+	}
+
+	BENCHMARK_NOINLINE int baselineLeaf(int value)
+	{
+		return value * 3 + 1;
+	}
+
+	BENCHMARK_NOINLINE unsigned suppressedLoop(const unsigned* values, int count)
+	{
+		unsigned hash = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			hash = hash * 31 + values[i];
+			DEBUG_INFO_MESSAGE
+				DEBUG_PRINT("\tvalue ", i, ' ', values[i], " hash ", hash);
+			DEBUG_END_MESSAGE
+		}
+		return hash;
+	}
+
+	BENCHMARK_NOINLINE unsigned baselineLoop(const unsigned* values, int count)
+	{
+		unsigned hash = 0;
+		for (int i = 0; i < count; ++i)
+			hash = hash * 31 + values[i];
+		return hash;
+	}
+}
+
+namespace
+{
+	volatile unsigned Sink;
+
+	template < typename Function >
+	double measure(Function function)
+	{
+		double best = 0.0;
+		for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+		{
+			const auto start = ::std::chrono::steady_clock::now();
+			function();
+			const auto stop = ::std::chrono::steady_clock::now();
+			const double ns = ::std::chrono::duration<double, ::std::nano>(stop - start).count() / BENCHMARK_ITERATIONS;
+			if (!repeat || ns < best)
+				best = ns;
+		}
+		return best;
+	}
+
+	void report(::std::FILE* results, long long started, const char* name, double suppressed, double baseline)
+	{
+		::std::printf("%-6s suppressed message : %.3f ns, without message : %.3f ns, difference : %.3f ns\n",
+			name, suppressed, baseline, suppressed - baseline);
+		if (results)
+			::std::fprintf(results,
+				"{\"benchmark\":\"suppressed_path\",\"library\":\"%s\",\"started\":%lld,\"case\":\"%s\","
+				"\"suppressed_ns\":%.3f,\"baseline_ns\":%.3f,\"difference_ns\":%.3f}\n",
+				DEBUG_LIB_HPP__, started, name, suppressed, baseline, suppressed - baseline);
+	}
+}
+
+int main()
+{
+	::DebugLib::SetGlobalLogLevel(::DebugLib::Level::Error);
+	::std::vector<unsigned> values(BENCHMARK_LOOP_SIZE);
+	for (::std::size_t i = 0; i < values.size(); ++i)
+		values[i] = static_cast<unsigned>(i * 2654435761u);
+
+	const auto leaf = [](int (*function)(int))
+	{
+		return [function]
+		{
+			int value = 0;
+			for (unsigned long long i = 0; i < BENCHMARK_ITERATIONS; ++i)
+				value = function(value);
+			Sink = static_cast<unsigned>(value);
+		};
+	};
+	const auto loop = [&values](unsigned (*function)(const unsigned*, int))
+	{
+		return [&values, function]
+		{
+			unsigned hash = 0;
+			for (unsigned long long i = 0; i < BENCHMARK_ITERATIONS / BENCHMARK_LOOP_SIZE; ++i)
+				hash += function(values.data(), BENCHMARK_LOOP_SIZE);
+			Sink = hash;
+		};
+	};
+
+	::std::FILE* results = ::std::fopen("DebugLib_Benchmark_Results.jsonl", "a");
+	const long long started = static_cast<long long>(::std::time(nullptr));
+	report(results, started, "leaf", measure(leaf(suppressedLeaf)), measure(leaf(baselineLeaf)));
+	report(results, started, "loop", measure(loop(suppressedLoop)), measure(loop(baselineLoop)));
+	if (results)
+		::std::fclose(results);
+	return 0;
+}
@@ -0,0 +1,228 @@
+/**
+*	DESCRIPTION:
+*		Measures throughput and producer latency of DebugLib messages written to one output sink.
+*		Sink is chosen when the benchmark is built (See: BENCHMARK_SINKS in Makefile), so every
+*		sink has its own executable named DebugLib_ThroughputBenchmark_<sink>.
+*		Every count of producer threads from 1 to the maximal one (powers of two) is measured with
+*		the message level enabled and suppressed by the global log level. Producer latency is the
+*		time between the start and the end of one message on the calling thread. Messages discarded
+*		by DEBUG_LIB_ASYNC_OVERFLOW_POLICY are counted and reported with the results.
+*		Results are printed as a table and appended to the results file as JSON lines.
+*		Usage: DebugLib_ThroughputBenchmark_<sink> [-n messages] [-j threads] [-o results]
+*			-n messages : count of messages written by all threads in one measurement (200000 by default)
+*			-j threads  : maximal count of producer threads (64 by default)
+*			-o results  : file to which results are appended (DebugLib_Benchmark_Results.jsonl by default)
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+**/
+/// STD
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+
+#if defined(_MSC_VER)
+#	define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#	define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+// Name of measured sink
+#ifndef BENCHMARK_SINK
+#	define BENCHMARK_SINK "file"
+#endif
+
+namespace
+{
+	typedef ::std::chrono::steady_clock Clock;
+
+	struct Options
+	{
+		unsigned long long messages = 200000;
+		unsigned threads = 64;
+		::std::string results = "DebugLib_Benchmark_Results.jsonl";
+	};
+
+	struct Result
+	{
+		unsigned threads;
+		bool enabled;
+		double messagesPerSecond;
+		::std::uint32_t p50;
+		::std::uint32_t p99;
+		::std::uint32_t p999;
+		::std::uint32_t max;
+		unsigned long long dropped;
+	};
+
+	unsigned long long droppedMessages()
+	{
+#ifdef DEBUG_LIB_ASYNC
+		return ::DebugLib::GetDroppedMessagesCount();
+#else
+		return 0;
+#endif
+	}
+
+	::std::uint32_t nanoseconds(Clock::duration duration)
+	{
+		const auto count = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(duration).count();
+		return static_cast<::std::uint32_t>(::std::min<long long>(count, UINT32_MAX));
+	}
+
+	/**
+	 *	@brief Writes messages and stores latency of every one of them.
+	 *	@param latencies Storage with capacity for all messages, so it is not reallocated during measurement.
+	 */
+	BENCHMARK_NOINLINE void produce(unsigned long long first, unsigned long long last, ::std::vector<::std::uint32_t>& latencies)
+	{
+		for (unsigned long long i = first; i < last; ++i)
+		{
+			const Clock::time_point start = Clock::now();
+			DEBUG_INFO_MESSAGE
+				DEBUG_PRINT("\tINFO message ", i);
+			DEBUG_END_MESSAGE
+			latencies.push_back(nanoseconds(Clock::now() - start));
+		}
+	}
+
+	/**
+	 *	@brief Measures the cost of reading the clock, which is included in every latency.
+	 */
+	::std::uint32_t clockOverhead()
+	{
+		::std::uint32_t best = UINT32_MAX;
+		for (int i = 0; i < 1000; ++i)
+		{
+			const Clock::time_point start = Clock::now();
+			best = ::std::min(best, nanoseconds(Clock::now() - start));
+		}
+		return best;
+	}
+
+	::std::uint32_t percentile(::std::vector<::std::uint32_t>& values, double fraction)
+	{
+		const ::std::size_t rank = static_cast<::std::size_t>(fraction * static_cast<double>(values.size()));
+		const auto nth = values.begin() + static_cast<::std::ptrdiff_t>(::std::min(rank, values.size() - 1));
+		::std::nth_element(values.begin(), nth, values.end());
+		return *nth;
+	}
+
+	Result measure(unsigned threads, bool enabled, unsigned long long messages)
+	{
+		::DebugLib::SetGlobalLogLevel(enabled ? ::DebugLib::Level::Info : ::DebugLib::Level::Error);
+		::std::vector<::std::vector<::std::uint32_t>> latencies(threads);
+		::std::atomic<unsigned> ready(0);
+		::std::atomic<bool> go(false);
+		::std::vector<::std::thread> producers;
+		const unsigned long long dropped = droppedMessages();
+		for (unsigned id = 0; id < threads; ++id)
+			producers.emplace_back([&, id]
+			{
+				const unsigned long long first = messages * id / threads;
+				const unsigned long long last = messages * (id + 1) / threads;
+				latencies[id].reserve(static_cast<::std::size_t>(last - first));
+				ready.fetch_add(1);
+				while (!go.load())
+					::std::this_thread::yield();
+				produce(first, last, latencies[id]);
+			});
+		while (ready.load() != threads)
+			::std::this_thread::yield();
+		const Clock::time_point start = Clock::now();
+		go.store(true);
+		for (auto& producer : producers)
+			producer.join();
+		const double seconds = ::std::chrono::duration<double>(Clock::now() - start).count();
+
+		::std::vector<::std::uint32_t> all;
+		all.reserve(static_cast<::std::size_t>(messages));
+		for (const auto& part : latencies)
+			all.insert(all.end(), part.begin(), part.end());
+		Result result;
+		result.threads = threads;
+		result.enabled = enabled;
+		result.messagesPerSecond = static_cast<double>(messages) / seconds;
+		result.max = *::std::max_element(all.begin(), all.end());
+		result.p50 = percentile(all, 0.5);
+		result.p99 = percentile(all, 0.99);
+		result.p999 = percentile(all, 0.999);
+		result.dropped = droppedMessages() - dropped;
+		return result;
+	}
+
+	int usage(const char* name)
+	{
+		::std::fprintf(stderr, "Usage: %s [-n messages] [-j threads] [-o results]\n", name);
+		return 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (::std::strlen(argv[i]) != 2 || argv[i][0] != '-' || i + 1 == argc)
+			return usage(argv[0]);
+		const char* value = argv[++i];
+		switch (argv[i - 1][1])
+		{
+		case 'n':
+			options.messages = ::std::max(1ull, ::std::strtoull(value, nullptr, 10));
+			break;
+		case 'j':
+			options.threads = static_cast<unsigned>(::std::max(1, ::std::atoi(value)));
+			break;
+		case 'o':
+			options.results = value;
+			break;
+		default:
+			return usage(argv[0]);
+		}
+	}
+
+#ifdef BENCHMARK_CLOG
+	// Messages still pass through std::clog, only the terminal is kept out of the measurement
+	if (!::std::freopen("DebugLib_Benchmark_clog.log", "a", stderr))
+		return 1;
+#endif
+	::std::FILE* results = ::std::fopen(options.results.c_str(), "a");
+	if (!results)
+	{
+		::std::printf("Can't open: %s\n", options.results.c_str());
+		return 1;
+	}
+
+	const long long started = static_cast<long long>(::std::time(nullptr));
+	const ::std::uint32_t overhead = clockOverhead();
+	::std::printf("Sink: %s, messages per measurement: %llu, clock overhead: %u ns\n", BENCHMARK_SINK, options.messages, overhead);
+	::std::printf("%-10s %8s %14s %10s %10s %10s %10s %10s\n", "level", "threads", "messages/s", "p50 ns", "p99 ns", "p999 ns", "max ns", "dropped");
+	for (int enabled = 1; enabled >= 0; --enabled)
+		for (unsigned threads = 1; threads <= options.threads; threads *= 2)
+		{
+			const Result result = measure(threads, enabled != 0, options.messages);
+			const char* const level = result.enabled ? "enabled" : "suppressed";
+			::std::printf("%-10s %8u %14.0f %10u %10u %10u %10u %10llu\n", level, result.threads, result.messagesPerSecond,
+				result.p50, result.p99, result.p999, result.max, result.dropped);
+			::std::fprintf(results,
+				"{\"benchmark\":\"throughput\",\"library\":\"%s\",\"started\":%lld,\"sink\":\"%s\",\"level\":\"%s\","
+				"\"threads\":%u,\"hardware_threads\":%u,\"messages\":%llu,\"messages_per_second\":%.0f,"
+				"\"p50_ns\":%u,\"p99_ns\":%u,\"p999_ns\":%u,\"max_ns\":%u,\"dropped\":%llu,\"clock_overhead_ns\":%u}\n",
+				DEBUG_LIB_HPP__, started, BENCHMARK_SINK, level, result.threads, ::std::thread::hardware_concurrency(),
+				options.messages, result.messagesPerSecond, result.p50, result.p99, result.p999, result.max, result.dropped, overhead);
+		}
+	::std::fclose(results);
+	return 0;
+}
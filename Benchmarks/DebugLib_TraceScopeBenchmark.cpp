@@ -0,0 +1,98 @@
+/**
+*	DESCRIPTION:
+*		Measures the cost of one traced scope (See: DEBUG_TRACE_SCOPE) compared with the same function
+*		without the scope. Scopes are traced in batches of half of the thread buffer, and the trace writer
+*		is given time to drain the buffer between batches, so no event is dropped.
+*		Results are printed and appended to DebugLib_Benchmark_Results.jsonl as JSON lines.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+**/
+/// STD
+#include <cstdio>
+#include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+
+#if defined(_MSC_VER)
+#	define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#	define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+// Count of scopes in one measurement : the buffer of thread is never filled
+#define BENCHMARK_BATCH (DEBUG_LIB_TRACE_BUFFER_SIZE / 2)
+// Count of measurements : the best one and the median are reported
+#define BENCHMARK_REPEATS 25
+// Time in milliseconds given to the trace writer to drain the buffer after every measurement
+#define BENCHMARK_DRAIN_TIME (DEBUG_LIB_TRACE_PERIOD * 3 / 2 + 1)
+// Cost of one traced scope expected on hardware with invariant timestamp counter in nanoseconds
+#define BENCHMARK_BUDGET_NS 20.0
+
+namespace
+{
+	volatile unsigned Sink;
+
+	BENCHMARK_NOINLINE void tracedScope(unsigned value)
+	{
+		DEBUG_TRACE_SCOPE("tracedScope");
+		Sink = value;
+	}
+
+	BENCHMARK_NOINLINE void baselineScope(unsigned value)
+	{
+		Sink = value;
+	}
+
+	/**
+	 *	@brief Measures function in batches.
+	 *	@param best Lowest cost of one call in nanoseconds.
+	 *	@param median Median cost of one call in nanoseconds.
+	 */
+	void measure(void (*function)(unsigned), double& best, double& median)
+	{
+		::std::vector<double> results;
+		for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+		{
+			const auto start = ::std::chrono::steady_clock::now();
+			for (unsigned i = 0; i < BENCHMARK_BATCH; ++i)
+				function(i);
+			const auto stop = ::std::chrono::steady_clock::now();
+			results.push_back(::std::chrono::duration<double, ::std::nano>(stop - start).count() / BENCHMARK_BATCH);
+			::std::this_thread::sleep_for(::std::chrono::milliseconds(BENCHMARK_DRAIN_TIME));
+		}
+		::std::sort(results.begin(), results.end());
+		best = results.front();
+		median = results[results.size() / 2];
+	}
+}
+
+int main()
+{
+	// Buffer of thread is taken and the trace writer is started before measurements
+	tracedScope(0);
+	double tracedBest, tracedMedian, baselineBest, baselineMedian;
+	measure(tracedScope, tracedBest, tracedMedian);
+	measure(baselineScope, baselineBest, baselineMedian);
+	const double cost = tracedBest - baselineBest;
+	::std::printf("traced scope : %.3f ns (median %.3f ns), without scope : %.3f ns (median %.3f ns), difference : %.3f ns%s\n",
+		tracedBest, tracedMedian, baselineBest, baselineMedian, cost,
+		cost > BENCHMARK_BUDGET_NS ? " : over budget, check that timestamp counter is read without a trap (virtual machines)" : "");
+
+	::std::FILE* results = ::std::fopen("DebugLib_Benchmark_Results.jsonl", "a");
+	if (results)
+	{
+		::std::fprintf(results,
+			"{\"benchmark\":\"trace_scope\",\"library\":\"%s\",\"started\":%lld,"
+			"\"traced_ns\":%.3f,\"traced_median_ns\":%.3f,\"baseline_ns\":%.3f,\"baseline_median_ns\":%.3f,\"difference_ns\":%.3f}\n",
+			DEBUG_LIB_HPP__, static_cast<long long>(::std::time(nullptr)),
+			tracedBest, tracedMedian, baselineBest, baselineMedian, cost);
+		::std::fclose(results);
+	}
+	return 0;
+}
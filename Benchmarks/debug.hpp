@@ -0,0 +1,11 @@
+#pragma once
+#define DEBUG
+#define DEBUG_LIB_THREAD_SAFETY
+// Throughput benchmark built for std::clog sink writes to the standard stream (See: BENCHMARK_SINKS in Makefile)
+#ifndef BENCHMARK_CLOG
+#	define DEBUG_LIB_FILE_LOG
+#	define DEBUG_LIB_LOG_FILE_NAME "DebugLib_Benchmark.log"
+#endif
+// Trace writer is started only by the trace scope benchmark
+#define DEBUG_LIB_TRACE
+#define DEBUG_LIB_TRACE_FILE_NAME "DebugLib_Benchmark_Trace.json"
@@ -1,86 +1,2836 @@
 #include <DebugLib/mDebugLib.hpp>
 
+#ifdef DEBUG_LIB_ASYNC
+/// STD for asynchronous output
+#	include <cstring>
+#	include <chrono>
+#	include <thread>
+#	include <condition_variable>
+/// DebugLib
+#	include "cMpscQueue.hpp"
+#endif
+
+#ifdef DEBUG_LIB_WRITEV
+#	if !defined(__unix__) && !defined(__APPLE__)
+#		error DEBUG_LIB_WRITEV is supported only on POSIX systems
+#	endif
+/// STD for batched output
+#	include <cerrno>
+#	include <climits>
+#	include <cstring>
+#	include <streambuf>
+#	include <vector>
+/// POSIX
+#	include <fcntl.h>
+#	include <sys/uio.h>
+#	include <unistd.h>
+//	Count of io vectors used by one record : timestamp text is a separate vector
+#	ifdef DEBUG_LIB_TIMESTAMP
+#		define DEBUG_LIB_WRITEV_RECORD_VECTORS 2
+#	else
+#		define DEBUG_LIB_WRITEV_RECORD_VECTORS 1
+#	endif
+#	if defined(IOV_MAX) && DEBUG_LIB_WRITEV_BATCH * DEBUG_LIB_WRITEV_RECORD_VECTORS > IOV_MAX
+#		error DEBUG_LIB_WRITEV_BATCH must not exceed IOV_MAX (half of it if DEBUG_LIB_TIMESTAMP is defined)
+#	endif
+#endif
+
+//	Size of own buffer of the log file whose descriptor is also written directly
+#ifdef DEBUG_LIB_CRASH_DRAIN
+#	define DEBUG_LIB_FILE_BUFFER_SIZE DEBUG_LIB_CRASH_BUFFER_SIZE
+#elif defined(DEBUG_LIB_WRITEV)
+#	define DEBUG_LIB_FILE_BUFFER_SIZE 4096
+#endif
+
+#ifdef DEBUG_LIB_TIMESTAMP
+/// STD for timestamps
+#	include <cstdint>
+#	include <atomic>
+#	include <chrono>
+#	include <condition_variable>
+#	include <mutex>
+#	include <thread>
+#endif
+
+#ifdef DEBUG_LIB_BINARY_LOG
+/// STD for binary output
+#	include <cstring>
+#	include <mutex>
+#	include <vector>
+#endif
+
+#if defined(DEBUG) && defined(DEBUG_LIB_SITE_IDS) && !defined(DEBUG_LIB_BINARY_LOG)
+/// STD for site table
+#	include <cstring>
+#	include <fstream>
+#	include <mutex>
+#	include <unordered_map>
+#endif
+
+#ifdef DEBUG_LIB_MMAP_LOG
+#	if !defined(__unix__) && !defined(__APPLE__)
+#		error DEBUG_LIB_MMAP_LOG is supported only on POSIX systems
+#	endif
+/// STD for memory mapped log
+#	include <cstdint>
+#	include <algorithm>
+#	include <streambuf>
+/// POSIX
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#ifdef DEBUG_LIB_LOG_ROTATION
+#	if !defined(__unix__) && !defined(__APPLE__)
+#		error DEBUG_LIB_LOG_ROTATION is supported only on POSIX systems
+#	endif
+/// STD for log rotation
+#	include <cstdint>
+#	include <cstdio>
+#	include <ctime>
+#	include <atomic>
+#	include <chrono>
+#	include <condition_variable>
+#	include <deque>
+#	include <fstream>
+#	include <mutex>
+#	include <streambuf>
+#	include <string>
+#	include <thread>
+/// POSIX
+#	include <sys/stat.h>
+#	include <unistd.h>
+/// DebugLib
+#	include "cLz4.hpp"
+#endif
+
+#ifdef DEBUG_LIB_FLUSH_POLICY
+/// STD for flush policy
+#	include <chrono>
+#	if defined(DEBUG_LIB_THREAD_SAFETY) && !defined(DEBUG_LIB_ASYNC)
+#		include <condition_variable>
+#		include <thread>
+#	endif
+#endif
+
+#ifdef DEBUG_LIB_LOG_INDEX
+/// STD for log index
+#	include <fstream>
+#	include <string>
+#	include <unordered_map>
+/// DebugLib
+#	include "cLogIndex.hpp"
+#endif
+
+#ifdef DEBUG_LIB_SINKS
+/// STD for sinks
+#	include <atomic>
+#	include <memory>
+#	include <mutex>
+#	include <vector>
+#endif
+
+#if defined(DEBUG) && defined(DEBUG_LIB_METRICS)
+/// STD for metrics
+#	include <cstdint>
+#	include <cstring>
+#	include <chrono>
+#	include <condition_variable>
+#	include <mutex>
+#	include <thread>
+#	include <vector>
+#endif
+
+#if defined(DEBUG) && defined(DEBUG_LIB_TRACE)
+/// STD for trace
+#	include <cstdint>
+#	include <atomic>
+#	include <chrono>
+#	include <condition_variable>
+#	include <fstream>
+#	include <mutex>
+#	include <thread>
+#	include <vector>
+#endif
+
+#ifdef DEBUG_LIB_CRASH_DRAIN
+#	if !defined(__unix__) && !defined(__APPLE__)
+#		error DEBUG_LIB_CRASH_DRAIN is supported only on POSIX systems
+#	endif
+/// STD for crash draining
+#	include <cerrno>
+#	include <cstring>
+#	include <atomic>
+#	include <streambuf>
+/// POSIX
+#	include <fcntl.h>
+#	include <signal.h>
+#	include <time.h>
+#	include <unistd.h>
+#endif
+
+#ifdef DEBUG_LIB_MMAP_LOG
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Stream buffer that appends output to a file through a shared memory mapping.
+	 *	File grows by chunks of DEBUG_LIB_MMAP_CHUNK_SIZE bytes and only the current chunk is mapped,
+	 *	so output is a plain copy and system calls are made only once per chunk. Flush does nothing:
+	 *	written bytes belong to the page cache at once, so they are kept by the kernel if the process
+	 *	crashes. On normal exit the file is truncated to the written size, after a crash the unused tail
+	 *	of the last chunk stays filled with zero bytes and is cut off by the next run (text logs only).
+	 */
+	class MappedFileBuffer : public ::std::streambuf
+	{
+	public:
+
+		explicit MappedFileBuffer(const char* name) :
+			fd(::open(name, O_RDWR | O_CREAT, 0644)),
+			chunk(0),
+			mapping(nullptr),
+			mappingOffset(0),
+			written(0)
+		{
+			const ::std::uint64_t page = static_cast<::std::uint64_t>(sysconf(_SC_PAGESIZE));
+			chunk = (static_cast<::std::uint64_t>(DEBUG_LIB_MMAP_CHUNK_SIZE) + page - 1) / page * page;
+			struct stat info;
+			if (fd < 0 || fstat(fd, &info) != 0)
+				return;
+			written = static_cast<::std::uint64_t>(info.st_size);
+#	ifndef DEBUG_LIB_BINARY_LOG
+			written = skipZeroTail(written);
+#	endif
+			map(written);
+		}
+
+		~MappedFileBuffer()
+		{
+			const ::std::uint64_t size = mapping ? position() : written;
+			unmap();
+			if (fd >= 0)
+			{
+				if (ftruncate(fd, static_cast<off_t>(size))) {}
+				close(fd);
+			}
+		}
+
+	protected:
+
+		int_type overflow(int_type ch) override
+		{
+			if (!mapping || !map(position()))
+				return traits_type::eof();
+			if (!traits_type::eq_int_type(ch, traits_type::eof()))
+			{
+				*pptr() = traits_type::to_char_type(ch);
+				pbump(1);
+			}
+			return traits_type::not_eof(ch);
+		}
+
+		int sync() override
+		{
+			return mapping ? 0 : -1;
+		}
+
+		// Only reports the current write position : used to obtain size of the log
+		pos_type seekoff(off_type off, ::std::ios_base::seekdir dir, ::std::ios_base::openmode which) override
+		{
+			if (off != 0 || dir == ::std::ios_base::beg || !(which & ::std::ios_base::out) || !mapping)
+				return pos_type(off_type(-1));
+			return pos_type(static_cast<off_type>(position()));
+		}
+
+	private:
+
+		::std::uint64_t position() const
+		{
+			return mappingOffset + static_cast<::std::uint64_t>(pptr() - pbase());
+		}
+
+		/**
+		 *	@brief Maps the chunk that contains offset and places output position to it.
+		 *	@param offset Count of bytes in file that are already written.
+		 */
+		bool map(::std::uint64_t offset)
+		{
+			unmap();
+			written = offset;
+			const ::std::uint64_t base = offset - offset % chunk;
+			if (ftruncate(fd, static_cast<off_t>(base + chunk)) != 0)
+				return false;
+			void* pointer = mmap(nullptr, chunk, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(base));
+			if (pointer == MAP_FAILED)
+				return false;
+			mapping = static_cast<char*>(pointer);
+			mappingOffset = base;
+			setp(mapping, mapping + chunk);
+			pbump(static_cast<int>(offset - base));
+			return true;
+		}
+
+		void unmap()
+		{
+			if (mapping)
+			{
+				munmap(mapping, chunk);
+				mapping = nullptr;
+				setp(nullptr, nullptr);
+			}
+		}
+
+		/**
+		 *	@brief Finds the end of text left by a crashed run.
+		 *	@return Size of file without trailing zero bytes of the last chunk.
+		 */
+		::std::uint64_t skipZeroTail(::std::uint64_t size)
+		{
+			char block[4096];
+			const ::std::uint64_t limit = size > chunk ? size - chunk : 0;
+			while (size > limit)
+			{
+				const ::std::uint64_t count = ::std::min<::std::uint64_t>(sizeof(block), size - limit);
+				if (pread(fd, block, static_cast<::std::size_t>(count), static_cast<off_t>(size - count)) != static_cast<ssize_t>(count))
+					return size;
+				for (::std::uint64_t i = count; i > 0; --i, --size)
+					if (block[i - 1] != '\0')
+						return size;
+			}
+			return size;
+		}
+
+		int fd;
+		::std::uint64_t chunk;
+		char* mapping;
+		::std::uint64_t mappingOffset;
+		::std::uint64_t written;
+
+		MappedFileBuffer(const MappedFileBuffer&) = delete;
+		MappedFileBuffer& operator=(const MappedFileBuffer&) = delete;
+	};
+}
+
+static DebugLib::MappedFileBuffer Debug_Lib_Log_Buffer__(DEBUG_LIB_LOG_FILE_NAME);
+
+#endif /* DEBUG_LIB_MMAP_LOG */
+
+#ifdef DEBUG_LIB_LOG_ROTATION
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Stream buffer that writes log file and switches it to a new one at size or time threshold.
+	 *	Owner of the stream (the thread holding the main mutex or the background writer) only checks the
+	 *	size and swaps file buffer pointers on flush. Background thread renames the full file to a segment
+	 *	name, opens the new file in advance, closes replaced file buffers and compresses closed segments.
+	 */
+	class RotatingFileBuffer : public ::std::streambuf
+	{
+	public:
+
+		explicit RotatingFileBuffer(const char* name) :
+			name(name),
+			current(new ::std::filebuf()),
+			written(0),
+			pending(nullptr),
+			requested(false),
+			stop(false),
+			sequence(0)
+		{
+			struct stat info;
+			if (stat(name, &info) == 0)
+				written.store(static_cast<::std::uint64_t>(info.st_size), ::std::memory_order_relaxed);
+			current->open(name, ::std::ios::app | ::std::ios::out);
+			setp(buffer, buffer + sizeof(buffer));
+			worker = ::std::thread(&RotatingFileBuffer::run, this);
+		}
+
+		~RotatingFileBuffer()
+		{
+			drain();
+			current->pubsync();
+			// Segment that is already renamed is finished with the rest
+			::std::filebuf* next = pending.exchange(nullptr, ::std::memory_order_acquire);
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				if (next)
+				{
+					retired.push_back(current);
+					current = next;
+				}
+				stop = true;
+			}
+			wake.notify_one();
+			worker.join();
+			delete current;
+		}
+
+	protected:
+
+		int_type overflow(int_type ch) override
+		{
+			if (!drain())
+				return traits_type::eof();
+			if (!traits_type::eq_int_type(ch, traits_type::eof()))
+			{
+				*pptr() = traits_type::to_char_type(ch);
+				pbump(1);
+			}
+			return traits_type::not_eof(ch);
+		}
+
+		int sync() override
+		{
+			if (!drain() || current->pubsync() != 0)
+				return -1;
+			rotate();
+			return 0;
+		}
+
+	private:
+
+		/**
+		 *	@brief Passes buffered output to the current file.
+		 */
+		bool drain()
+		{
+			const ::std::streamsize count = pptr() - pbase();
+			setp(buffer, buffer + sizeof(buffer));
+			if (count && current->sputn(buffer, count) != count)
+				return false;
+			written.store(written.load(::std::memory_order_relaxed) + static_cast<::std::uint64_t>(count), ::std::memory_order_relaxed);
+			return true;
+		}
+
+		/**
+		 *	@brief Called at message boundary : requests rotation and swaps prepared file in.
+		 */
+		void rotate()
+		{
+			if (DEBUG_LIB_LOG_ROTATION_SIZE && written.load(::std::memory_order_relaxed) >= DEBUG_LIB_LOG_ROTATION_SIZE &&
+				!requested.exchange(true, ::std::memory_order_relaxed))
+				notify();
+			::std::filebuf* next = pending.exchange(nullptr, ::std::memory_order_acquire);
+			if (!next)
+				return;
+			::std::filebuf* previous = current;
+			current = next;
+			written.store(0, ::std::memory_order_relaxed);
+			requested.store(false, ::std::memory_order_relaxed);
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				retired.push_back(previous);
+			}
+			wake.notify_one();
+		}
+
+		void notify()
+		{
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+			}
+			wake.notify_one();
+		}
+
+		void run()
+		{
+			const auto period = ::std::chrono::seconds(DEBUG_LIB_LOG_ROTATION_PERIOD);
+			auto deadline = ::std::chrono::steady_clock::now() + period;
+			::std::unique_lock<::std::mutex> lock(mutex);
+			for (;;)
+			{
+				// Next file is prepared first so compression does not delay rotation
+				const auto now = ::std::chrono::steady_clock::now();
+				const bool due = period.count() && now >= deadline;
+				if (due)
+					deadline = now + period;
+				const bool empty = !written.load(::std::memory_order_relaxed);
+				if (!stop && !pending.load(::std::memory_order_relaxed) && (requested.load(::std::memory_order_relaxed) || (due && !empty)))
+				{
+					lock.unlock();
+					prepare();
+					lock.lock();
+				}
+				// Every retired file buffer belongs to the oldest renamed segment
+				if (!retired.empty())
+				{
+					::std::filebuf* previous = retired.front();
+					retired.pop_front();
+					const ::std::string segment = segments.front();
+					segments.pop_front();
+					lock.unlock();
+					delete previous;
+#	if DEBUG_LIB_LOG_ROTATION_COMPRESS
+					compress(segment);
+#	endif
+					lock.lock();
+					continue;
+				}
+				if (stop)
+					return;
+				if (period.count())
+					wake.wait_until(lock, deadline);
+				else
+					wake.wait(lock);
+			}
+		}
+
+		/**
+		 *	@brief Renames current file to a new segment name and opens a new file under the log name.
+		 *	Current file buffer keeps writing to the renamed file until it is swapped.
+		 */
+		void prepare()
+		{
+			const ::std::string segment = segmentName();
+			if (::std::rename(name, segment.c_str()) != 0)
+			{
+				// Rotation is requested again by the next flush
+				requested.store(false, ::std::memory_order_relaxed);
+				return;
+			}
+			::std::filebuf* next = new ::std::filebuf();
+			next->open(name, ::std::ios::app | ::std::ios::out);
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				segments.push_back(segment);
+			}
+			pending.store(next, ::std::memory_order_release);
+		}
+
+		/**
+		 *	@brief Builds unused name of the form "<log name>.<date>-<time>.<number>".
+		 */
+		::std::string segmentName()
+		{
+			const ::std::time_t now = ::std::time(nullptr);
+			::std::tm local;
+			localtime_r(&now, &local);
+			char stamp[32];
+			::std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+			for (;;)
+			{
+				const ::std::string segment = ::std::string(name) + "." + stamp + "." + ::std::to_string(sequence++);
+				if (access(segment.c_str(), F_OK) != 0 && access((segment + ".lz4").c_str(), F_OK) != 0)
+					return segment;
+			}
+		}
+
+		static void compress(const ::std::string& segment)
+		{
+			const ::std::string packed = segment + ".lz4";
+			bool done;
+			{
+				::std::ifstream input(segment, ::std::ios::in | ::std::ios::binary);
+				::std::ofstream output(packed, ::std::ios::out | ::std::ios::trunc | ::std::ios::binary);
+				done = input && output && Lz4::CompressStream(input, output);
+			}
+			::std::remove(done ? segment.c_str() : packed.c_str());
+		}
+
+		const char* const name;
+		// Used only by the owner of the stream
+		::std::filebuf* current;
+		char buffer[4096];
+		// Written by the owner of the stream, read by the background thread
+		::std::atomic<::std::uint64_t> written;
+		::std::atomic<::std::filebuf*> pending;
+		::std::atomic<bool> requested;
+		// Guarded by mutex
+		bool stop;
+		::std::deque<::std::filebuf*> retired;
+		::std::deque<::std::string> segments;
+		// Used only by the background thread
+		unsigned sequence;
+		::std::mutex mutex;
+		::std::condition_variable wake;
+		::std::thread worker;
+
+		RotatingFileBuffer(const RotatingFileBuffer&) = delete;
+		RotatingFileBuffer& operator=(const RotatingFileBuffer&) = delete;
+	};
+}
+
+static DebugLib::RotatingFileBuffer Debug_Lib_Log_Buffer__(DEBUG_LIB_LOG_FILE_NAME);
+
+#endif /* DEBUG_LIB_LOG_ROTATION */
+
+#if defined(DEBUG_LIB_CRASH_DRAIN) || defined(DEBUG_LIB_WRITEV)
+
+namespace DebugLib
+{
+#	if defined(DEBUG_LIB_FILE_LOG) || defined(DEBUG_LIB_ASYNC)
+	/**
+	 *	@brief Writes all bytes to file descriptor with raw write calls. Async-signal-safe.
+	 *	@return true if all bytes were written, false otherwise.
+	 */
+	static bool WriteAll(int fd, const char* data, ::std::size_t size)
+	{
+		while (size)
+		{
+			const ssize_t done = ::write(fd, data, size);
+			if (done < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+			data += done;
+			size -= static_cast<::std::size_t>(done);
+		}
+		return true;
+	}
+#	endif
+
+#	ifdef DEBUG_LIB_FILE_LOG
+	/**
+	 *	@brief Stream buffer that appends output to a file through its own fixed buffer.
+	 *	Unlike std::filebuf the buffer and the file descriptor are accessible, so output that was
+	 *	not flushed yet may be written by a fatal signal handler and the batched output stage
+	 *	writes to the same descriptor.
+	 */
+	class FileDescriptorBuffer : public ::std::streambuf
+	{
+	public:
+
+		explicit FileDescriptorBuffer(const char* name) :
+			fd(::open(name, O_WRONLY | O_CREAT | O_APPEND, 0644))
+		{
+			setp(buffer, buffer + sizeof(buffer));
+		}
+
+		~FileDescriptorBuffer()
+		{
+			flush();
+			if (fd >= 0)
+				close(fd);
+		}
+
+		int descriptor() const
+		{
+			return fd;
+		}
+
+		/**
+		 *	@brief Writes buffered output without changing the buffer. Async-signal-safe.
+		 */
+		void drain() const
+		{
+			if (fd >= 0)
+				WriteAll(fd, pbase(), static_cast<::std::size_t>(pptr() - pbase()));
+		}
+
+	protected:
+
+		int_type overflow(int_type ch) override
+		{
+			if (!flush())
+				return traits_type::eof();
+			if (!traits_type::eq_int_type(ch, traits_type::eof()))
+			{
+				*pptr() = traits_type::to_char_type(ch);
+				pbump(1);
+			}
+			return traits_type::not_eof(ch);
+		}
+
+		::std::streamsize xsputn(const char_type* data, ::std::streamsize count) override
+		{
+			if (count > epptr() - pptr())
+			{
+				if (!flush())
+					return 0;
+				// Output longer than the buffer is not copied
+				if (count >= static_cast<::std::streamsize>(sizeof(buffer)))
+					return WriteAll(fd, data, static_cast<::std::size_t>(count)) ? count : 0;
+			}
+			::std::memcpy(pptr(), data, static_cast<::std::size_t>(count));
+			pbump(static_cast<int>(count));
+			return count;
+		}
+
+		int sync() override
+		{
+			return flush() ? 0 : -1;
+		}
+
+		// Only reports the current write position : used to obtain size of the log
+		pos_type seekoff(off_type off, ::std::ios_base::seekdir dir, ::std::ios_base::openmode which) override
+		{
+			if (off != 0 || dir == ::std::ios_base::beg || !(which & ::std::ios_base::out) || fd < 0)
+				return pos_type(off_type(-1));
+			const off_t size = lseek(fd, 0, SEEK_END);
+			if (size < 0)
+				return pos_type(off_type(-1));
+			return pos_type(static_cast<off_type>(size) + (pptr() - pbase()));
+		}
+
+	private:
+
+		bool flush()
+		{
+			// Buffer is emptied only after it is written, so it is drained on crash until then
+			const bool written = fd >= 0 && WriteAll(fd, buffer, static_cast<::std::size_t>(pptr() - pbase()));
+			setp(buffer, buffer + sizeof(buffer));
+			return written;
+		}
+
+		int fd;
+		char buffer[DEBUG_LIB_FILE_BUFFER_SIZE];
+
+		FileDescriptorBuffer(const FileDescriptorBuffer&) = delete;
+		FileDescriptorBuffer& operator=(const FileDescriptorBuffer&) = delete;
+	};
+#	endif
+}
+
+#	ifdef DEBUG_LIB_FILE_LOG
+static DebugLib::FileDescriptorBuffer Debug_Lib_Log_Buffer__(DEBUG_LIB_LOG_FILE_NAME);
+#	endif
+
+#endif /* DEBUG_LIB_CRASH_DRAIN || DEBUG_LIB_WRITEV */
+
+#ifdef DEBUG_LIB_CRASH_DRAIN
+
+namespace DebugLib
+{
+	/**
+	 *	@brief State of output draining : 0 - not started, 1 - in progress, 2 - finished.
+	 */
+	static ::std::atomic<int> Debug_Lib_Drain_State__(0);
+}
+
+#endif /* DEBUG_LIB_CRASH_DRAIN */
+
 namespace DebugLib
 {
 
-#ifdef DEBUG_LIB_FILE_LOG
+#if defined(DEBUG_LIB_MMAP_LOG) || defined(DEBUG_LIB_LOG_ROTATION) || \
+	((defined(DEBUG_LIB_CRASH_DRAIN) || defined(DEBUG_LIB_WRITEV)) && defined(DEBUG_LIB_FILE_LOG))
+	::std::ostream DEBUG_LIB_LOG_FILE_VAR_NAME(&Debug_Lib_Log_Buffer__);
+#elif defined(DEBUG_LIB_FILE_LOG)
+#	ifdef DEBUG_LIB_BINARY_LOG
+    ::std::ofstream DEBUG_LIB_LOG_FILE_VAR_NAME(DEBUG_LIB_LOG_FILE_NAME, ::std::fstream::app | ::std::fstream::out | ::std::fstream::binary);
+#	else
     ::std::ofstream DEBUG_LIB_LOG_FILE_VAR_NAME(DEBUG_LIB_LOG_FILE_NAME, ::std::fstream::app | ::std::fstream::out);
+#	endif
 #endif
 
 #ifdef DEBUG_LIB_THREAD_SAFETY
     ::std::mutex DEBUG_LIB_MUTEX_VAR_NAME;
+	LogLevelStorage DEBUG_LIB_LOG_LEVEL_VAR_NAME = { { DEBUG_LIB_DEFAULT_LOG_LEVEL } };
+#else
+	int DEBUG_LIB_LOG_LEVEL_VAR_NAME = DEBUG_LIB_DEFAULT_LOG_LEVEL;
 #endif
 
-    class LogLevel
-    {
-	public:
+#ifdef DEBUG_LIB_MODULE_LEVELS
+	// Zero initialized before any dynamic initialization : all modules use global log level
+#	ifdef DEBUG_LIB_THREAD_SAFETY
+	::std::atomic<int> DEBUG_LIB_MODULE_LEVELS_VAR_NAME[DEBUG_LIB_MODULE_COUNT];
+#	else
+	int DEBUG_LIB_MODULE_LEVELS_VAR_NAME[DEBUG_LIB_MODULE_COUNT];
+#	endif
+#endif
+}
+
+bool DebugLib::try_SetGlobalLogLevel(DebugLib::Level l)
+{
+#ifdef DEBUG_LIB_THREAD_SAFETY
+	int dummy = DEBUG_LIB_LOG_LEVEL_VAR_NAME.value.load(::std::memory_order_relaxed);
+	return DEBUG_LIB_LOG_LEVEL_VAR_NAME.value.compare_exchange_strong(dummy, static_cast<int>(l), ::std::memory_order_release, ::std::memory_order_relaxed);
+#else
+	DEBUG_LIB_LOG_LEVEL_VAR_NAME = static_cast<int>(l);
+	return true;
+#endif
+}
 
-		LogLevel(::DebugLib::Level level) : logLevel(level) {}
-		
-    protected:
-		friend Level DebugLib::GetGlobalLogLevel();
-		friend bool DebugLib::try_SetGlobalLogLevel(Level l);
-		friend void DebugLib::SetGlobalLogLevel(Level l);
+void DebugLib::SetGlobalLogLevel(DebugLib::Level l)
+{
 #ifdef DEBUG_LIB_THREAD_SAFETY
-		Level getLogLevel() 
+	DEBUG_LIB_LOG_LEVEL_VAR_NAME.value.store(static_cast<int>(l), ::std::memory_order_release);
+#else
+	DEBUG_LIB_LOG_LEVEL_VAR_NAME = static_cast<int>(l);
+#endif
+}
+
+#ifdef DEBUG_LIB_MODULE_LEVELS
+
+/**
+ *	@brief Stores raw value of module level table slot.
+ *	@param stored Zero for global log level or level plus one.
+ */
+static bool StoreModuleLogLevel(::std::size_t module, int stored)
+{
+	if (module >= DEBUG_LIB_MODULE_COUNT)
+		return false;
+#	ifdef DEBUG_LIB_THREAD_SAFETY
+	DebugLib::DEBUG_LIB_MODULE_LEVELS_VAR_NAME[module].store(stored, ::std::memory_order_release);
+#	else
+	DebugLib::DEBUG_LIB_MODULE_LEVELS_VAR_NAME[module] = stored;
+#	endif
+	return true;
+}
+
+bool DebugLib::SetModuleLogLevel(::std::size_t module, DebugLib::Level l)
+{
+	return StoreModuleLogLevel(module, static_cast<int>(l) + 1);
+}
+
+bool DebugLib::ResetModuleLogLevel(::std::size_t module)
+{
+	return StoreModuleLogLevel(module, 0);
+}
+
+#endif /* DEBUG_LIB_MODULE_LEVELS */
+
+#if defined(DEBUG_LIB_TIMESTAMP) || (defined(DEBUG) && defined(DEBUG_LIB_TRACE))
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Converts timestamp counter values to wall time.
+	 *	Anchor values of the counter, system clock and steady clock are taken on construction.
+	 *	Rate of the counter is measured against steady clock by a background thread that waits
+	 *	DEBUG_LIB_TIMESTAMP_CALIBRATION milliseconds after the anchor and is not changed afterwards,
+	 *	so conversion never sleeps and preserves the order of counter values converted after calibration.
+	 *	Values converted earlier use the rate measured up to the moment of conversion.
+	 *	Must be used by one thread at a time: the background writer or the owner of the main mutex.
+	 *	Trace writer converts trace events with a clock of its own.
+	 */
+	class TimestampClock
+	{
+	public:
+
+		TimestampClock() :
+			calibrated(false),
+			nanosecondsPerTick(1.0),
+			stop(false)
+		{
+			sample<::std::chrono::system_clock>(anchorTicks, anchorWall);
+			sample<::std::chrono::steady_clock>(steadyTicks, anchorSteady);
+			calibrator = ::std::thread(&TimestampClock::calibrate, this);
+		}
+
+		~TimestampClock()
 		{
-			return static_cast<Level>(logLevel.load());
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_one();
+			calibrator.join();
 		}
 
-		bool try_SetLogLevel(Level l) 
+		/**
+		 *	@brief Converts timestamp counter value to nanoseconds since epoch (UTC).
+		 */
+		::std::uint64_t toWallTime(::std::uint64_t ticks)
 		{
-			int dummy = logLevel.load();
-			return logLevel.compare_exchange_strong(dummy, static_cast<int>(l));
+			const double rate = calibrated.load(::std::memory_order_acquire) ? nanosecondsPerTick : measureRate();
+			const double delta = static_cast<double>(static_cast<::std::int64_t>(ticks - anchorTicks));
+			return static_cast<::std::uint64_t>(anchorWall + static_cast<::std::int64_t>(delta * rate));
 		}
 
-		void setLogLevel(Level l)
+		/**
+		 *	@brief Checks whether rate of the counter is already measured.
+		 */
+		bool isCalibrated() const
 		{
-			int dummy = logLevel.load();
-			while (!logLevel.compare_exchange_weak(dummy, static_cast<int>(l)));
+			return calibrated.load(::std::memory_order_acquire);
 		}
+
 	private:
-		std::atomic<int>  logLevel;	
-#else
-		Level getLogLevel()
+
+		/**
+		 *	@brief Reads clock between two counter reads and takes the middle of them as the counter value.
+		 *	The narrowest of several attempts is used, so a preemption during the read does not skew the result.
+		 */
+		template < typename Clock >
+		static void sample(::std::uint64_t& ticks, ::std::int64_t& nanoseconds)
 		{
-			return static_cast<Level>(logLevel);
+			::std::uint64_t width = ~static_cast<::std::uint64_t>(0);
+			ticks = 0;
+			nanoseconds = 0;
+			for (int attempt = 0; attempt < 8; ++attempt)
+			{
+				const ::std::uint64_t before = ReadTimestampCounter();
+				const auto now = Clock::now().time_since_epoch();
+				const ::std::uint64_t after = ReadTimestampCounter();
+				if (after - before >= width)
+					continue;
+				width = after - before;
+				ticks = before + width / 2;
+				nanoseconds = static_cast<::std::int64_t>(::std::chrono::duration_cast<::std::chrono::nanoseconds>(now).count());
+			}
 		}
 
-		bool try_SetLogLevel(Level l) 
+		/**
+		 *	@brief Measures rate of the counter since the anchor.
+		 */
+		double measureRate() const
 		{
-			logLevel = static_cast<int>(l);
-			return true;
+			::std::uint64_t ticks;
+			::std::int64_t steady;
+			sample<::std::chrono::steady_clock>(ticks, steady);
+			return ticks != steadyTicks ? static_cast<double>(steady - anchorSteady) / static_cast<double>(ticks - steadyTicks) : 1.0;
 		}
 
-		void setLogLevel(Level l)
+		void calibrate()
 		{
-			logLevel = static_cast<int>(l);
+			{
+				// Clock destroyed earlier stops the wait, the rate measured so far is still stored
+				::std::unique_lock<::std::mutex> lock(mutex);
+				wake.wait_for(lock, ::std::chrono::milliseconds(DEBUG_LIB_TIMESTAMP_CALIBRATION), [this]() { return stop; });
+			}
+			nanosecondsPerTick = measureRate();
+			calibrated.store(true, ::std::memory_order_release);
 		}
-	private:
-		int logLevel;	
-#endif
-		LogLevel(const LogLevel&) {}
-		LogLevel& operator=(const LogLevel&) { return *this; }
-		//* (//* -> /* (remove first slash) if C++98 is used)
-		LogLevel(LogLevel&&) {}
-		LogLevel& operator=(LogLevel&&) { return *this; }
-		//*/
+
+		::std::atomic<bool> calibrated;
+		double nanosecondsPerTick;	//!< Written by calibrating thread before calibrated is set
+		::std::uint64_t anchorTicks;
+		::std::int64_t anchorWall;
+		::std::uint64_t steadyTicks;
+		::std::int64_t anchorSteady;
+		bool stop;
+		::std::mutex mutex;
+		::std::condition_variable wake;
+		::std::thread calibrator;
+
+		TimestampClock(const TimestampClock&) = delete;
+		TimestampClock& operator=(const TimestampClock&) = delete;
 	};
 }
 
-static DebugLib::LogLevel Debug_Lib_Log_State__(DEBUG_LIB_DEFAULT_LOG_LEVEL);
+#endif /* DEBUG_LIB_TIMESTAMP || DEBUG && DEBUG_LIB_TRACE */
 
-DebugLib::Level DebugLib::GetGlobalLogLevel()
+#ifdef DEBUG_LIB_TIMESTAMP
+
+namespace DebugLib
 {
-    return Debug_Lib_Log_State__.getLogLevel();
+	/**
+	 *	@brief Provides access to the clock. 
+	 *	Clock is created on first use, so records converted during static initialization are handled too.
+	 */
+	static TimestampClock& GetTimestampClock()
+	{
+		static TimestampClock clock;
+		return clock;
+	}
+
+#	ifndef DEBUG_LIB_BINARY_LOG
+	/**
+	 *	@brief Formats wall time of record as the text prefix of message.
+	 *	@param out Buffer of at least DEBUG_LIB_TIMESTAMP_TEXT_SIZE characters.
+	 *	@return Count of characters written.
+	 */
+	static ::std::size_t FormatRecordTime(const Record& record, char* out)
+	{
+		static TimestampFormatter formatter;
+		return formatter.format(GetTimestampClock().toWallTime(record.ticks), out);
+	}
+#	endif
 }
 
-bool DebugLib::try_SetGlobalLogLevel(DebugLib::Level l)
+// Clock is created at startup, so calibration runs in the background before the first messages are written
+static DebugLib::TimestampClock& Debug_Lib_Timestamp_Clock__ = DebugLib::GetTimestampClock();
+
+#endif /* DEBUG_LIB_TIMESTAMP */
+
+#ifdef DEBUG_LIB_BINARY_LOG
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Storage of registered call site headers.
+	 *	Identifiers are given in order of registration starting from 0.
+	 */
+	class SiteRegistry
+	{
+	public:
+
+		::std::uint32_t add(const char* header)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			headers.push_back(header);
+			return static_cast<::std::uint32_t>(headers.size() - 1);
+		}
+
+		const char* get(::std::uint32_t site)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			return site < headers.size() ? headers[site] : "";
+		}
+
+	private:
+		::std::mutex mutex;
+		::std::vector<const char*> headers;
+	};
+
+	static SiteRegistry& GetSiteRegistry()
+	{
+		static SiteRegistry registry;
+		return registry;
+	}
+
+	/**
+	 *	@brief Writes frames of binary log to DEBUG_OUT.
+	 *	Site frames are written lazily: all sites up to the one of current message are defined first,
+	 *	so dropped or reordered messages never leave a site undefined.
+	 *	Must be used by one thread at a time: the background writer or the owner of the main mutex.
+	 */
+	struct BinaryWriter
+	{
+		bool sessionStarted;
+		::std::uint32_t definedSites;
+
+		void write(const Record& record)
+		{
+			char frame[16];
+			char* out;
+			if (!sessionStarted)
+			{
+				out = frame;
+				put(out, static_cast<char>(SessionFrame));
+				put(out, static_cast<::std::uint32_t>(DEBUG_LIB_BINARY_VERSION));
+				DEBUG_OUT.write(frame, out - frame);
+				sessionStarted = true;
+			}
+			for (; definedSites <= record.site; ++definedSites)
+			{
+				const char* header = GetSiteRegistry().get(definedSites);
+				out = frame;
+				put(out, static_cast<char>(SiteFrame));
+				put(out, definedSites);
+				put(out, static_cast<::std::uint32_t>(::std::strlen(header)));
+				DEBUG_OUT.write(frame, out - frame);
+				DEBUG_OUT.write(header, ::std::strlen(header));
+			}
+#	ifdef DEBUG_LIB_TIMESTAMP
+			out = frame;
+			put(out, static_cast<char>(TimeFrame));
+			put(out, GetTimestampClock().toWallTime(record.ticks));
+			DEBUG_OUT.write(frame, out - frame);
+#	endif
+			out = frame;
+			put(out, static_cast<char>(MessageFrame));
+			put(out, record.site);
+			put(out, static_cast<::std::uint8_t>(record.level));
+			put(out, static_cast<::std::uint32_t>(record.size));
+			DEBUG_OUT.write(frame, out - frame);
+			DEBUG_OUT.write(record.data, record.size);
+		}
+
+		template < typename T >
+		static void put(char*& out, T value)
+		{
+			::std::memcpy(out, &value, sizeof(T));
+			out += sizeof(T);
+		}
+	};
+}
+
+// Zero initialized : usable even before dynamic initialization of this file
+static DebugLib::BinaryWriter Debug_Lib_Binary_Writer__;
+
+::std::uint32_t DebugLib::RegisterSite(const char* header)
 {
-    return Debug_Lib_Log_State__.try_SetLogLevel(l);
+	return GetSiteRegistry().add(header);
 }
 
-void DebugLib::SetGlobalLogLevel(DebugLib::Level l)
+#endif /* DEBUG_LIB_BINARY_LOG */
+
+#if defined(DEBUG) && defined(DEBUG_LIB_SITE_IDS) && !defined(DEBUG_LIB_BINARY_LOG)
+
+namespace DebugLib
 {
-	Debug_Lib_Log_State__.setLogLevel(l);
-}
\ No newline at end of file
+	/**
+	 *	@brief Appends headers of call sites to DEBUG_LIB_SITE_TABLE_FILE_NAME, one "@xxxxxxxx header" line per site.
+	 *	Lines are flushed as they are written, so the table is complete even if the process crashes.
+	 *	Tables of several runs may be appended to the same file: equal headers have equal identifiers.
+	 *	Identifiers are not probed on collision, as the next free identifier would depend on the order of registration
+	 *	and differ between runs. Header that collides keeps its text in messages and is not written to the table.
+	 */
+	class SiteTable
+	{
+	public:
+
+		SiteTable() : file(DEBUG_LIB_SITE_TABLE_FILE_NAME, ::std::fstream::app | ::std::fstream::out) {}
+
+		bool add(const char* header, ::std::uint32_t& id)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			id = HashSiteHeader(header);
+			const auto site = sites.emplace(id, header);
+			// Call sites with equal headers (several messages on one line) share one identifier
+			if (!site.second)
+				return !::std::strcmp(site.first->second, header);
+			char text[DEBUG_LIB_SITE_ID_TEXT_SIZE];
+			FormatSiteId(id, text);
+			file << text << ' ' << header << ::std::endl;
+			return true;
+		}
+
+	private:
+		::std::mutex mutex;
+		::std::unordered_map<::std::uint32_t, const char*> sites;
+		::std::ofstream file;
+
+		SiteTable(const SiteTable&) = delete;
+		SiteTable& operator=(const SiteTable&) = delete;
+	};
+
+	static SiteTable& GetSiteTable()
+	{
+		static SiteTable table;
+		return table;
+	}
+}
+
+// Table is created on static initialization, so it outlives call sites registered later
+static DebugLib::SiteTable& Debug_Lib_Site_Table__ = DebugLib::GetSiteTable();
+
+bool DebugLib::InternSite(const char* header, ::std::uint32_t& id)
+{
+	return GetSiteTable().add(header, id);
+}
+
+#endif /* DEBUG && DEBUG_LIB_SITE_IDS && !DEBUG_LIB_BINARY_LOG */
+
+#ifdef DEBUG_LIB_LOG_INDEX
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Writes sidecar index of the log file.
+	 *	Offsets are counted from the size of the log file at the first message, so the index
+	 *	stays valid when several runs append to the same log. Source file names are taken from
+	 *	the static message header once per call site.
+	 *	Must be used by one thread at a time: the background writer or the owner of the main mutex.
+	 */
+	class LogIndexWriter
+	{
+	public:
+
+		LogIndexWriter() :
+			file(DEBUG_LIB_LOG_INDEX_FILE_NAME, ::std::fstream::app | ::std::fstream::out | ::std::fstream::binary),
+			started(false),
+			offset(0)
+		{}
+
+		/**
+		 *	@brief Adds entry for the record that is about to be written to the log.
+		 *	@param prefix Count of bytes written to the log right before the record data.
+		 */
+		void add(const Record& record, ::std::size_t prefix)
+		{
+			if (!started)
+			{
+				DEBUG_LIB_LOG_FILE_VAR_NAME.seekp(0, ::std::fstream::end);
+				const ::std::streamoff position = DEBUG_LIB_LOG_FILE_VAR_NAME.tellp();
+				offset = position > 0 ? static_cast<::std::uint64_t>(position) : 0;
+				put(static_cast<char>(IndexSessionFrame));
+				put(static_cast<::std::uint32_t>(DEBUG_LIB_INDEX_VERSION));
+				started = true;
+			}
+			const ::std::uint32_t id = getFileId(record.header);
+			put(static_cast<char>(IndexEntryFrame));
+			put(offset);
+			put(static_cast<::std::uint32_t>(prefix + record.size));
+			put(static_cast<::std::uint8_t>(record.level));
+			put(id);
+			offset += prefix + record.size;
+		}
+
+		void flush()
+		{
+			file.flush();
+		}
+
+	private:
+
+		::std::uint32_t getFileId(const char* header)
+		{
+			const auto site = sites.find(header);
+			if (site != sites.end())
+				return site->second;
+			::std::uint32_t id = DEBUG_LIB_INDEX_NO_FILE;
+			::std::size_t length = 0;
+			const char* name = GetHeaderFile(header, length);
+			if (name)
+			{
+				const ::std::string key(name, length);
+				const auto known = files.find(key);
+				if (known == files.end())
+				{
+					id = static_cast<::std::uint32_t>(files.size());
+					files.emplace(key, id);
+					put(static_cast<char>(IndexFileFrame));
+					put(id);
+					put(static_cast<::std::uint32_t>(length));
+					file.write(name, length);
+				}
+				else
+					id = known->second;
+			}
+			sites.emplace(header, id);
+			return id;
+		}
+
+		template < typename T >
+		void put(T value)
+		{
+			file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		::std::ofstream file;
+		bool started;
+		::std::uint64_t offset;
+		::std::unordered_map<const char*, ::std::uint32_t> sites;
+		::std::unordered_map<::std::string, ::std::uint32_t> files;
+
+		LogIndexWriter(const LogIndexWriter&) = delete;
+		LogIndexWriter& operator=(const LogIndexWriter&) = delete;
+	};
+}
+
+static DebugLib::LogIndexWriter Debug_Lib_Log_Index__;
+
+#endif /* DEBUG_LIB_LOG_INDEX */
+
+#ifdef DEBUG_LIB_SINKS
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Registry of sinks that routes every record to sinks of its level.
+	 *	Sinks are registered from any thread under the registry mutex and every change publishes
+	 *	a new version of the route list. Records are routed by one thread at a time: the background
+	 *	writer or the owner of the main mutex. That thread keeps its own copy of the list and copies it
+	 *	again only when the version changes, so routing of a record takes no locks.
+	 */
+	class SinkRegistry
+	{
+		struct Route
+		{
+			::std::size_t id;
+			Level level;
+			::std::shared_ptr<Sink> sink;
+			bool written;	//!< Sink has messages written after the last flush
+		};
+
+	public:
+
+		SinkRegistry() : nextId(DefaultSink + 1), version(1), seen(0)
+		{
+			routes.push_back(Route{ DefaultSink, Level::All, ::std::make_shared<StreamSink>(DEBUG_OUT), false });
+		}
+
+		::std::size_t add(::std::shared_ptr<Sink> sink, Level level)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			const ::std::size_t id = nextId++;
+			routes.push_back(Route{ id, level, ::std::move(sink), false });
+			version.fetch_add(1, ::std::memory_order_release);
+			return id;
+		}
+
+		bool remove(::std::size_t id)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			for (auto route = routes.begin(); route != routes.end(); ++route)
+				if (route->id == id)
+				{
+					routes.erase(route);
+					version.fetch_add(1, ::std::memory_order_release);
+					return true;
+				}
+			return false;
+		}
+
+		bool setLevel(::std::size_t id, Level level)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			for (Route& route : routes)
+				if (route.id == id)
+				{
+					route.level = level;
+					version.fetch_add(1, ::std::memory_order_release);
+					return true;
+				}
+			return false;
+		}
+
+		/**
+		 *	@brief Passes record to every sink of its level.
+		 *	@param stamp Formatted timestamp of record or empty string.
+		 */
+		void write(const Record& record, const char* stamp)
+		{
+			refresh();
+			for (Route& route : active)
+				if (record.level >= static_cast<int>(route.level))
+				{
+					route.sink->write(record, stamp);
+					route.written = true;
+				}
+		}
+
+		/**
+		 *	@brief Flushes sinks that have messages written after their last flush.
+		 */
+		void flush()
+		{
+			for (Route& route : active)
+				if (route.written)
+				{
+					route.sink->flush();
+					route.written = false;
+				}
+		}
+
+	private:
+
+		void refresh()
+		{
+			if (version.load(::std::memory_order_acquire) == seen)
+				return;
+			// Sinks that are removed now are released with all their output flushed
+			flush();
+			::std::lock_guard<::std::mutex> lock(mutex);
+			active = routes;
+			seen = version.load(::std::memory_order_relaxed);
+		}
+
+		::std::mutex mutex;
+		::std::vector<Route> routes;				//!< Registered sinks, guarded by mutex
+		::std::size_t nextId;
+		::std::atomic<unsigned> version;
+		::std::vector<Route> active;				//!< Copy of routes used by the thread that writes records
+		unsigned seen;								//!< Version of routes that active was copied from
+
+		SinkRegistry(const SinkRegistry&) = delete;
+		SinkRegistry& operator=(const SinkRegistry&) = delete;
+	};
+
+	/**
+	 *	@brief Provides access to the registry.
+	 *	Registry is created on first use, so sinks may be registered during static initialization.
+	 */
+	static SinkRegistry& GetSinkRegistry()
+	{
+		static SinkRegistry registry;
+		return registry;
+	}
+}
+
+// Registry is created at startup, so it is destroyed after objects of this file that write records
+static DebugLib::SinkRegistry& Debug_Lib_Sink_Registry__ = DebugLib::GetSinkRegistry();
+
+::std::size_t DebugLib::AddSink(::std::shared_ptr<DebugLib::Sink> sink, DebugLib::Level level)
+{
+	return GetSinkRegistry().add(::std::move(sink), level);
+}
+
+bool DebugLib::RemoveSink(::std::size_t id)
+{
+	return GetSinkRegistry().remove(id);
+}
+
+bool DebugLib::SetSinkLevel(::std::size_t id, DebugLib::Level level)
+{
+	return GetSinkRegistry().setLevel(id, level);
+}
+
+#endif /* DEBUG_LIB_SINKS */
+
+// Batched output stage writes records on its own
+#if defined(DEBUG_LIB_RECORD_OUTPUT) && !defined(DEBUG_LIB_WRITEV)
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Sends one finished record to DEBUG_OUT or to sinks of its level without flushing.
+	 */
+	static void WriteRecord(const Record& record)
+	{
+#	if defined(DEBUG_LIB_BINARY_LOG)
+		Debug_Lib_Binary_Writer__.write(record);
+#	elif defined(DEBUG_LIB_LOG_INDEX)
+		// Record is written as is so its size matches the index entry
+#		ifdef DEBUG_LIB_TIMESTAMP
+		char stamp[DEBUG_LIB_TIMESTAMP_TEXT_SIZE];
+		const ::std::size_t stampSize = FormatRecordTime(record, stamp);
+		Debug_Lib_Log_Index__.add(record, stampSize);
+		DEBUG_OUT.write(stamp, stampSize);
+#		else
+		Debug_Lib_Log_Index__.add(record, 0);
+#		endif
+		DEBUG_OUT.write(record.data, record.size);
+#	elif defined(DEBUG_LIB_SINKS)
+#		ifdef DEBUG_LIB_TIMESTAMP
+		char stamp[DEBUG_LIB_TIMESTAMP_TEXT_SIZE];
+		FormatRecordTime(record, stamp);
+		GetSinkRegistry().write(record, stamp);
+#		else
+		GetSinkRegistry().write(record, "");
+#		endif
+#	else
+#		ifdef DEBUG_LIB_TIMESTAMP
+		char stamp[DEBUG_LIB_TIMESTAMP_TEXT_SIZE];
+		FormatRecordTime(record, stamp);
+		DEBUG_OUT << stamp;
+#		endif
+		DEBUG_OUT << record.data;
+#	endif
+	}
+
+	/**
+	 *	@brief Flushes DEBUG_OUT and all accompanying outputs.
+	 */
+	static void FlushOutput()
+	{
+#	ifdef DEBUG_LIB_SINKS
+		GetSinkRegistry().flush();
+#	else
+		DEBUG_OUT << DEBUG_LIB_FLUSH;
+#	endif
+#	ifdef DEBUG_LIB_LOG_INDEX
+		Debug_Lib_Log_Index__.flush();
+#	endif
+	}
+}
+
+#endif /* DEBUG_LIB_RECORD_OUTPUT && !DEBUG_LIB_WRITEV */
+
+#ifdef DEBUG_LIB_FLUSH_POLICY
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Decides when written records are flushed.
+	 *	Output is flushed when any enabled condition holds. Must be used by one thread at a time:
+	 *	the background writer or the owner of the main mutex.
+	 */
+	class FlushPolicy
+	{
+		typedef ::std::chrono::steady_clock Clock;
+
+	public:
+
+		FlushPolicy() : messages(0), bytes(0), flushedAt(Clock::now()) {}
+
+		/**
+		 *	@brief Accounts record that was written to the output.
+		 *	@return true if output must be flushed now.
+		 */
+		bool written(const Record& record)
+		{
+			++messages;
+			bytes += record.size;
+			return record.level >= DEBUG_LIB_FLUSH_LEVEL ||
+				(MessagesLimit && messages >= MessagesLimit) ||
+				(BytesLimit && bytes >= BytesLimit) ||
+				expired();
+		}
+
+		/**
+		 *	@brief Checks whether written records wait for flush longer than DEBUG_LIB_FLUSH_PERIOD.
+		 */
+		bool expired() const
+		{
+			return DEBUG_LIB_FLUSH_PERIOD && messages &&
+				Clock::now() - flushedAt >= ::std::chrono::milliseconds(DEBUG_LIB_FLUSH_PERIOD);
+		}
+
+		bool pending() const
+		{
+			return messages != 0;
+		}
+
+		void flushed()
+		{
+			messages = 0;
+			bytes = 0;
+			if (DEBUG_LIB_FLUSH_PERIOD)
+				flushedAt = Clock::now();
+		}
+
+	private:
+		static const ::std::size_t MessagesLimit = DEBUG_LIB_FLUSH_MESSAGES;
+		static const ::std::size_t BytesLimit = DEBUG_LIB_FLUSH_BYTES;
+
+		::std::size_t messages;
+		::std::size_t bytes;
+		Clock::time_point flushedAt;
+	};
+}
+
+#endif /* DEBUG_LIB_FLUSH_POLICY */
+
+#ifdef DEBUG_LIB_WRITEV
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Output stage of background writer that submits many records with one writev call.
+	 *	Records are not copied : io vectors point to queue slots that are kept until the batch is written.
+	 *	Writes to the descriptor of DEBUG_OUT if DEBUG_LIB_FILE_LOG is defined or to the standard error stream otherwise.
+	 */
+	class BatchWriter
+	{
+	public:
+
+		//	Ticket of record that is not kept in a queue slot
+		static const ::std::size_t NoTicket = ~static_cast<::std::size_t>(0);
+
+		BatchWriter() :
+#	ifdef DEBUG_LIB_TIMESTAMP
+			stamps(DEBUG_LIB_WRITEV_BATCH * DEBUG_LIB_TIMESTAMP_TEXT_SIZE),
+#	endif
+			tickets(DEBUG_LIB_WRITEV_BATCH),
+			vectors(DEBUG_LIB_WRITEV_BATCH * DEBUG_LIB_WRITEV_RECORD_VECTORS),
+			count(0),
+			vectorCount(0)
+		{}
+
+		/**
+		 *	@brief Adds record to the batch. Record must stay unchanged until the batch is written.
+		 *	Must not be called if batch is full.
+		 *	@param ticket Ticket of queue slot that holds the record or NoTicket.
+		 */
+		void add(const Record& record, ::std::size_t ticket)
+		{
+#	ifdef DEBUG_LIB_TIMESTAMP
+			char* const stamp = &stamps[count * DEBUG_LIB_TIMESTAMP_TEXT_SIZE];
+			vectors[vectorCount].iov_base = stamp;
+			vectors[vectorCount].iov_len = FormatRecordTime(record, stamp);
+			++vectorCount;
+#	endif
+			vectors[vectorCount].iov_base = const_cast<char*>(record.data);
+			vectors[vectorCount].iov_len = record.size;
+			++vectorCount;
+			tickets[count++] = ticket;
+		}
+
+		bool empty() const { return !count; }
+		bool full() const { return count == DEBUG_LIB_WRITEV_BATCH; }
+
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+		/**
+		 *	@brief Writes records of the batch without emptying it. Async-signal-safe.
+		 */
+		void drain() const
+		{
+			const int fd = descriptor();
+			for (::std::size_t i = 0; i < vectorCount && fd >= 0; ++i)
+				WriteAll(fd, static_cast<const char*>(vectors[i].iov_base), vectors[i].iov_len);
+		}
+#	endif
+
+		/**
+		 *	@brief Writes all records of the batch and empties it.
+		 *	@param release Callable that receives ticket of every written record kept in a queue slot.
+		 */
+		template < typename Release >
+		void write(Release&& release)
+		{
+			const int fd = descriptor();
+			iovec* vector = vectors.data();
+			int left = static_cast<int>(vectorCount);
+			while (left && fd >= 0)
+			{
+				ssize_t done = writev(fd, vector, left);
+				if (done < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					break;
+				}
+				// Skip fully written records and adjust the partially written one
+				for (; left && static_cast<::std::size_t>(done) >= vector->iov_len; --left, ++vector)
+					done -= static_cast<ssize_t>(vector->iov_len);
+				if (left)
+				{
+					vector->iov_base = static_cast<char*>(vector->iov_base) + done;
+					vector->iov_len -= static_cast<::std::size_t>(done);
+				}
+			}
+			// Batch is emptied before its slots are reused, so it is drained on crash until then
+			const ::std::size_t written = count;
+			count = 0;
+			vectorCount = 0;
+			for (::std::size_t i = 0; i < written; ++i)
+				if (tickets[i] != NoTicket)
+					release(tickets[i]);
+		}
+
+	private:
+
+		static int descriptor()
+		{
+#	ifdef DEBUG_LIB_FILE_LOG
+			return Debug_Lib_Log_Buffer__.descriptor();
+#	else
+			return STDERR_FILENO;
+#	endif
+		}
+
+#	ifdef DEBUG_LIB_TIMESTAMP
+		::std::vector<char> stamps;
+#	endif
+		::std::vector<::std::size_t> tickets;
+		::std::vector<iovec> vectors;
+		::std::size_t count;
+		::std::size_t vectorCount;
+
+		BatchWriter(const BatchWriter&) = delete;
+		BatchWriter& operator=(const BatchWriter&) = delete;
+	};
+}
+
+#endif /* DEBUG_LIB_WRITEV */
+
+#if defined(DEBUG_LIB_CRASH_DRAIN) && defined(DEBUG_LIB_ASYNC)
+
+namespace DebugLib
+{
+	class AsyncWriter;
+
+	/**
+	 *	@brief Running background writer : set by its constructor and cleared by its destructor.
+	 */
+	static ::std::atomic<AsyncWriter*> Debug_Lib_Crash_Writer__(nullptr);
+
+	/**
+	 *	@brief Marks the background writer thread.
+	 */
+	static thread_local bool Debug_Lib_Writer_Thread__ = false;
+
+	/**
+	 *	@brief Writes one record with raw write calls. Async-signal-safe.
+	 *	Timestamp is written only if the clock is already calibrated.
+	 */
+	static void WriteRecordRaw(int fd, const Record& record)
+	{
+#	ifdef DEBUG_LIB_TIMESTAMP
+		TimestampClock& clock = GetTimestampClock();
+		if (clock.isCalibrated())
+		{
+			TimestampFormatter formatter;
+			char stamp[DEBUG_LIB_TIMESTAMP_TEXT_SIZE];
+			WriteAll(fd, stamp, formatter.format(clock.toWallTime(record.ticks), stamp));
+		}
+#	endif
+		WriteAll(fd, record.data, record.size);
+	}
+}
+
+#endif /* DEBUG_LIB_CRASH_DRAIN && DEBUG_LIB_ASYNC */
+
+#ifdef DEBUG_LIB_ASYNC
+
+namespace DebugLib
+{
+	//	First line of the warning about discarded messages
+	static const char Debug_Lib_Drop_Report_Header__[] = "WARNING::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__);
+
+	/**
+	 *	@brief Background writer that drains message records to DEBUG_OUT.
+	 *	Producers copy finished records into the lock-free queue and never touch the output.
+	 *	Writer takes all available records and flushes DEBUG_OUT once per such batch.
+	 *	If queue is full the DEBUG_LIB_ASYNC_OVERFLOW_POLICY decides what happens to the message.
+	 *	Discarded messages are counted by level and reported by one warning record each time the writer empties the queue.
+	 */
+	class AsyncWriter
+	{
+	public:
+
+		AsyncWriter() :
+#	ifdef DEBUG_LIB_BINARY_LOG
+			reportSite(RegisterSite(Debug_Lib_Drop_Report_Header__)),
+#	endif
+			stop(false),
+			sleeping(false),
+#	ifdef DEBUG_LIB_WRITEV
+			batching(false),
+#	endif
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+			busy(false),
+#	endif
+			worker(&AsyncWriter::run, this)
+		{
+			for (int level = 0; level < Level::Nothing; ++level)
+			{
+				dropped[level].store(0, ::std::memory_order_relaxed);
+				reported[level] = 0;
+			}
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+			Debug_Lib_Crash_Writer__.store(this);
+#	endif
+		}
+
+		~AsyncWriter()
+		{
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+			Debug_Lib_Crash_Writer__.store(nullptr);
+#	endif
+			stop.store(true);
+			wake();
+			worker.join();
+		}
+
+		/**
+		 *	@brief Copies record to the queue.
+		 *	May block only if DEBUG_LIB_ASYNC_OVERFLOW_POLICY is OverflowPolicy::Block,
+		 *	waits at most DEBUG_LIB_ASYNC_OVERFLOW_WAIT microseconds if it is OverflowPolicy::DropAfterWait.
+		 *	@param record Finished message record.
+		 */
+		void push(const Record& record)
+		{
+			::std::chrono::steady_clock::time_point deadline;
+			const auto fill = [&record](Record& slot)
+			{
+				slot.size = record.size;
+				slot.level = record.level;
+				slot.site = record.site;
+#	ifdef DEBUG_LIB_TIMESTAMP
+				slot.ticks = record.ticks;
+#	endif
+				slot.header = record.header;
+				::std::memcpy(slot.data, record.data, record.size + 1);
+			};
+			while (!queue.try_push(fill))
+			{
+#	ifdef DEBUG_LIB_WRITEV
+				// Writer that waits to fill a batch is woken as soon as queue is full
+				if (batching.load())
+					wake();
+#	endif
+				switch (DEBUG_LIB_ASYNC_OVERFLOW_POLICY)
+				{
+				case OverflowPolicy::DropNewest:
+					drop(record.level);
+					return;
+				case OverflowPolicy::DropOldest:
+				{
+					int level = Level::Nothing;
+					if (queue.try_pop([&level](Record& oldest) { level = oldest.level; }))
+						drop(level);
+					else
+						// Only records taken by the writer are left : their slots are freed when they are written
+						::std::this_thread::yield();
+					break;
+				}
+				case OverflowPolicy::DropAfterWait:
+				{
+					// Clock is read only when queue is full
+					const auto now = ::std::chrono::steady_clock::now();
+					if (deadline == ::std::chrono::steady_clock::time_point())
+						deadline = now + ::std::chrono::microseconds(DEBUG_LIB_ASYNC_OVERFLOW_WAIT);
+					else if (now >= deadline)
+					{
+						drop(record.level);
+						return;
+					}
+				}
+				// fall through
+				default:
+					if (sleeping.load())
+						wake();
+					::std::this_thread::yield();
+				}
+			}
+			if (sleeping.load())
+				wake();
+		}
+
+		/**
+		 *	@brief Count of messages of given level discarded since program start.
+		 */
+		::std::size_t droppedCount(int level) const
+		{
+			return dropped[level].load(::std::memory_order_relaxed);
+		}
+
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+		/**
+		 *	@brief Waits until the writer thread finishes the record it has taken. Async-signal-safe.
+		 *	Writer takes no records while output is drained, so the queue and the output stay put.
+		 *	Wait is limited in case the writer thread is stopped.
+		 */
+		void settle() const
+		{
+			const timespec pause = { 0, 1000000 };
+			for (int i = 0; i < 1000 && !Debug_Lib_Writer_Thread__ && busy.load(); ++i)
+				nanosleep(&pause, nullptr);
+		}
+
+		/**
+		 *	@brief Writes the collected batch and all queued records with raw write calls. Async-signal-safe.
+		 *	Nothing is removed, so output that the writer thread is writing concurrently may appear twice.
+		 *	@param fd Descriptor of the log file.
+		 */
+		void drain(int fd) const
+		{
+#		ifdef DEBUG_LIB_WRITEV
+			batch.drain();
+#		endif
+			queue.peek([fd](const Record& record) { WriteRecordRaw(fd, record); });
+		}
+#	endif
+
+	private:
+
+		void wake()
+		{
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+			}
+			notEmpty.notify_one();
+		}
+
+		void drop(int level)
+		{
+			dropped[level].fetch_add(1, ::std::memory_order_relaxed);
+		}
+
+		/**
+		 *	@brief Builds the warning record with counts of messages discarded since the previous report.
+		 *	Called by the writer thread when the queue is empty, so the report follows the messages that were kept.
+		 *	@return Pointer to the report or nullptr if nothing was discarded or warnings are disabled.
+		 */
+		const Record* takeDropReport()
+		{
+			::std::size_t counts[Level::Nothing];
+			bool any = false;
+			for (int level = 0; level < Level::Nothing; ++level)
+			{
+				counts[level] = dropped[level].load(::std::memory_order_relaxed) - reported[level];
+				reported[level] += counts[level];
+				any = any || counts[level];
+			}
+			if (!any || !DEBUG_LIB_WARNING_ENABLED)
+				return nullptr;
+#	ifdef DEBUG_LIB_BINARY_LOG
+			BinaryRecordStream& out = report.open(Level::Warning, reportSite);
+#	else
+			RecordStream& out = report.open(Level::Warning, Debug_Lib_Drop_Report_Header__);
+			out << Debug_Lib_Drop_Report_Header__ << DEBUG_LIB_NEXT_LINE;
+#	endif
+			out << "\tmessages dropped on full output queue" << DEBUG_LIB_NEXT_LINE;
+			static const char* const names[Level::Nothing] = { "INFO", "WARNING", "ERROR", "USER" };
+			for (int level = 0; level < Level::Nothing; ++level)
+				if (counts[level])
+					out << '\t' << names[level] << ' ' << counts[level] << DEBUG_LIB_NEXT_LINE;
+			return &out.close();
+		}
+
+		/**
+		 *	@brief Takes the oldest record from the queue.
+		 *	If DEBUG_LIB_WRITEV is defined the record stays in its slot until the slot is released with its ticket.
+		 *	@param consume Callable that receives reference to the record (and its ticket if DEBUG_LIB_WRITEV is defined).
+		 *	@return true if record was taken, false if queue is empty.
+		 */
+		template < typename Consume >
+		bool take(Consume&& consume)
+		{
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+			// Record taken during draining would be neither in the queue nor in the drained output
+			for (;;)
+			{
+				busy.store(true);
+				if (Debug_Lib_Drain_State__.load() != 1)
+					break;
+				busy.store(false);
+				::std::this_thread::sleep_for(::std::chrono::milliseconds(1));
+			}
+			const bool taken = takeRecord(consume);
+			busy.store(false);
+			return taken;
+#	else
+			return takeRecord(consume);
+#	endif
+		}
+
+		template < typename Consume >
+		bool takeRecord(Consume& consume)
+		{
+#	ifdef DEBUG_LIB_WRITEV
+			::std::size_t ticket;
+			Record* const record = queue.try_acquire(ticket);
+			if (!record)
+				return false;
+			consume(*record, ticket);
+			return true;
+#	else
+			return queue.try_pop(consume);
+#	endif
+		}
+
+		void run()
+		{
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+			Debug_Lib_Writer_Thread__ = true;
+#	endif
+			for (;;)
+			{
+				// Stop flag is read before draining so records pushed before it was set are written
+				const bool stopping = stop.load();
+#	if defined(DEBUG_LIB_WRITEV)
+				// Batch is collected until it is full or its first record waits for DEBUG_LIB_WRITEV_DELAY
+				const auto deadline = ::std::chrono::steady_clock::now() + ::std::chrono::microseconds(DEBUG_LIB_WRITEV_DELAY);
+				for (;;)
+				{
+					while (!batch.full() && take([this](Record& record, ::std::size_t ticket) { batch.add(record, ticket); }));
+					if (batch.empty() || batch.full() || stopping)
+						break;
+					if (::std::chrono::steady_clock::now() >= deadline)
+						break;
+					::std::unique_lock<::std::mutex> lock(mutex);
+					batching.store(true);
+					// Producers that find queue full keep retrying so a wake-up can not be missed for long
+					notEmpty.wait_until(lock, deadline);
+					batching.store(false);
+				}
+				// Batch that is not full took all queued records, report is built once per batch as it is not copied
+				if (!batch.full())
+					if (const Record* report = takeDropReport())
+						batch.add(*report, BatchWriter::NoTicket);
+				if (!batch.empty())
+				{
+					batch.write([this](::std::size_t ticket) { queue.release(ticket); });
+					continue;
+				}
+#	elif defined(DEBUG_LIB_FLUSH_POLICY)
+				bool written = false;
+				while (take([this](Record& record) { write(record); }))
+					written = true;
+				if (const Record* report = takeDropReport())
+				{
+					write(*report);
+					written = true;
+				}
+				if (written)
+					continue;
+				if (policy.pending() && (stopping || policy.expired()))
+				{
+					FlushOutput();
+					policy.flushed();
+				}
+#	else
+				::std::size_t written = 0;
+				while (take([](Record& record) { WriteRecord(record); }))
+					++written;
+				if (const Record* report = takeDropReport())
+				{
+					WriteRecord(*report);
+					++written;
+				}
+				if (written)
+				{
+					FlushOutput();
+					continue;
+				}
+#	endif
+				if (stopping)
+					break;
+				::std::unique_lock<::std::mutex> lock(mutex);
+				sleeping.store(true);
+				// Timeout guards against notification missed between the check and the wait
+				if (queue.empty() && !stop.load())
+					notEmpty.wait_for(lock, ::std::chrono::milliseconds(DEBUG_LIB_ASYNC_IDLE_WAIT));
+				sleeping.store(false);
+			}
+		}
+
+#	if defined(DEBUG_LIB_WRITEV)
+		BatchWriter batch;
+#	elif defined(DEBUG_LIB_FLUSH_POLICY)
+		void write(const Record& record)
+		{
+			WriteRecord(record);
+			if (policy.written(record))
+			{
+				FlushOutput();
+				policy.flushed();
+			}
+		}
+
+		FlushPolicy policy;
+#	endif
+		MpscQueue<Record, DEBUG_LIB_ASYNC_QUEUE_SIZE> queue;
+		alignas(DEBUG_LIB_CACHE_LINE_SIZE) ::std::atomic<::std::size_t> dropped[Level::Nothing];	//!< Discarded messages by level
+		::std::size_t reported[Level::Nothing];	//!< Discarded messages by level included in reports : used by writer thread only
+#	ifdef DEBUG_LIB_BINARY_LOG
+		BinaryRecordStream report;
+		const ::std::uint32_t reportSite;
+#	else
+		RecordStream report;
+#	endif
+		::std::atomic<bool> stop;
+		::std::atomic<bool> sleeping;
+#	ifdef DEBUG_LIB_WRITEV
+		::std::atomic<bool> batching;
+#	endif
+#	ifdef DEBUG_LIB_CRASH_DRAIN
+		::std::atomic<bool> busy;	//!< Writer thread is taking a record
+#	endif
+		::std::mutex mutex;
+		::std::condition_variable notEmpty;
+		::std::thread worker;
+
+		AsyncWriter(const AsyncWriter&) = delete;
+		AsyncWriter& operator=(const AsyncWriter&) = delete;
+	};
+
+	/**
+	 *	@brief Provides access to the writer. 
+	 *	Writer thread is started on first message and stopped on static destruction after all records are written.
+	 */
+	static AsyncWriter& GetAsyncWriter()
+	{
+#	ifdef DEBUG_LIB_SINKS
+		// Registry is created before the writer so it outlives the last records written on exit
+		GetSinkRegistry();
+#	endif
+		static AsyncWriter writer;
+		return writer;
+	}
+
+	static void PublishRecord(const Record& record)
+	{
+		GetAsyncWriter().push(record);
+	}
+}
+
+::std::size_t DebugLib::GetDroppedMessagesCount()
+{
+	::std::size_t count = 0;
+	for (int level = 0; level < Level::Nothing; ++level)
+		count += GetAsyncWriter().droppedCount(level);
+	return count;
+}
+
+::std::size_t DebugLib::GetDroppedMessagesCount(DebugLib::Level level)
+{
+	return level >= 0 && level < Level::Nothing ? GetAsyncWriter().droppedCount(level) : 0;
+}
+
+#elif defined(DEBUG_LIB_RECORD_OUTPUT)
+
+#	ifdef DEBUG_LIB_FLUSH_POLICY
+static DebugLib::FlushPolicy Debug_Lib_Flush_Policy__;
+
+#		if defined(DEBUG_LIB_THREAD_SAFETY) && DEBUG_LIB_FLUSH_PERIOD
+namespace DebugLib
+{
+	/**
+	 *	@brief Background thread that flushes output left unflushed for DEBUG_LIB_FLUSH_PERIOD.
+	 *	Takes the main mutex once per period to check for written records.
+	 */
+	class FlushTimer
+	{
+	public:
+
+		FlushTimer() : stop(false), worker(&FlushTimer::run, this) {}
+
+		~FlushTimer()
+		{
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_one();
+			worker.join();
+		}
+
+	private:
+
+		void run()
+		{
+			::std::unique_lock<::std::mutex> lock(mutex);
+			while (!stop)
+			{
+				wake.wait_for(lock, ::std::chrono::milliseconds(DEBUG_LIB_FLUSH_PERIOD));
+				::std::lock_guard<::std::mutex> output(DEBUG_LIB_MUTEX_VAR_NAME);
+				if (Debug_Lib_Flush_Policy__.pending())
+				{
+					FlushOutput();
+					Debug_Lib_Flush_Policy__.flushed();
+				}
+			}
+		}
+
+		bool stop;
+		::std::mutex mutex;
+		::std::condition_variable wake;
+		::std::thread worker;
+
+		FlushTimer(const FlushTimer&) = delete;
+		FlushTimer& operator=(const FlushTimer&) = delete;
+	};
+}
+
+static DebugLib::FlushTimer Debug_Lib_Flush_Timer__;
+#		endif
+#	endif
+
+namespace DebugLib
+{
+	static void PublishRecord(const Record& record)
+	{
+#	ifdef DEBUG_LIB_THREAD_SAFETY
+		// Message is already formatted : critical section is one append and flush
+		::std::lock_guard<::std::mutex> DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME(DEBUG_LIB_MUTEX_VAR_NAME);
+#	endif
+		WriteRecord(record);
+#	ifdef DEBUG_LIB_FLUSH_POLICY
+		if (!Debug_Lib_Flush_Policy__.written(record))
+			return;
+		Debug_Lib_Flush_Policy__.flushed();
+#	endif
+		FlushOutput();
+	}
+}
+
+#endif /* DEBUG_LIB_ASYNC */
+
+#ifdef DEBUG_LIB_RECORD_OUTPUT
+
+void DebugLib::CommitRecord(DebugLib::RecordStream& stream)
+{
+	PublishRecord(stream.close());
+}
+
+#	ifdef DEBUG_LIB_BINARY_LOG
+void DebugLib::CommitRecord(DebugLib::BinaryRecordStream& stream)
+{
+	PublishRecord(stream.close());
+}
+#	endif
+
+#endif /* DEBUG_LIB_RECORD_OUTPUT */
+
+#ifdef DEBUG
+
+namespace DebugLib
+{
+#	ifndef DEBUG_LIB_RECORD_OUTPUT
+	template < typename Out >
+	static auto FlushStream(Out& out, int) -> decltype(out.flush(), void())
+	{
+		out.flush();
+	}
+
+	//	Output without flush member flushes by itself
+	template < typename Out >
+	static void FlushStream(Out&, long) {}
+#	endif
+
+#	ifdef DEBUG_LIB_BINARY_LOG
+	typedef BinaryRecordStream LibraryStream;
+#	else
+	typedef RecordStream LibraryStream;
+#	endif
+
+	/**
+	 *	@brief Writes message of the library itself without message macros.
+	 *	Message is formatted into a record on the stack and passed to the output directly, so it may be
+	 *	written by background threads and static destructors and does not depend on DEBUG_LIB_FLUSH.
+	 *	@param level Level of the message.
+	 *	@param header Static first line of the message, empty if format writes the first line.
+	 *	@param format Callable that receives the output stream of the message.
+	 */
+	template < typename Format >
+	static void WriteLibraryMessage(Level level, const char* header, Format&& format)
+	{
+		if (level < DEBUG_LIB_MIN_LEVEL || !DEBUG_LIB_LEVEL_ENABLED(level))
+			return;
+#	ifdef DEBUG_LIB_BINARY_LOG
+		BinaryRecordStream out;
+		out.open(level, RegisterSite(header));
+		format(out);
+		PublishRecord(out.close());
+#	else
+		RecordStream out;
+		out.open(level, header);
+		if (*header)
+			out << header << DEBUG_LIB_NEXT_LINE;
+		format(out);
+#		ifdef DEBUG_LIB_RECORD_OUTPUT
+		PublishRecord(out.close());
+#		else
+		const Record& record = out.close();
+#			ifdef DEBUG_LIB_THREAD_SAFETY
+		::std::lock_guard<::std::mutex> DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME(DEBUG_LIB_MUTEX_VAR_NAME);
+#			endif
+		DEBUG_OUT << static_cast<const char*>(record.data);
+		FlushStream(DEBUG_OUT, 0);
+#		endif
+#	endif
+	}
+
+	/**
+	 *	@brief Head of the list of call sites that suppressed messages.
+	 *	Sites are only added and never removed : they are static objects of message macros.
+	 */
+	static ::std::atomic<SuppressionSite*> Debug_Lib_Suppression_Sites__(nullptr);
+
+	/**
+	 *	@brief Steady clock time in nanoseconds after which the next summary may be written.
+	 */
+	static ::std::atomic<::std::int64_t> Debug_Lib_Suppression_Summary_Time__(0);
+
+	/**
+	 *	@brief Writes one message with suppressed counts of all sites and resets them.
+	 *	Nothing is written if no messages were suppressed since the previous summary.
+	 */
+	static void WriteSuppressionSummary()
+	{
+		SuppressionSite* const head = Debug_Lib_Suppression_Sites__.load(::std::memory_order_acquire);
+		SuppressionSite* site = head;
+		while (site && !site->suppressed.load(::std::memory_order_relaxed))
+			site = site->next;
+		if (!site)
+			return;
+		WriteLibraryMessage(Level::User, "", [head](LibraryStream& out)
+		{
+			out << "SUMMARY::suppressed messages" << DEBUG_LIB_NEXT_LINE;
+			for (SuppressionSite* site = head; site; site = site->next)
+			{
+				const ::std::uint64_t count = site->suppressed.exchange(0, ::std::memory_order_relaxed);
+				if (count)
+					out << '\t' << site->header << ' ' << count << DEBUG_LIB_NEXT_LINE;
+			}
+		});
+	}
+}
+
+void DebugLib::RegisterSuppressionSite(DebugLib::SuppressionSite& site)
+{
+	if (site.registered.exchange(true))
+		return;
+#	ifdef DEBUG_LIB_ASYNC
+	GetAsyncWriter();
+#	endif
+	// Registered after the output is created, so the last summary is written before the output is destroyed
+	static const int exitSummary = ::std::atexit(WriteSuppressionSummary);
+	(void)exitSummary;
+	SuppressionSite* head = Debug_Lib_Suppression_Sites__.load(::std::memory_order_relaxed);
+	do
+		site.next = head;
+	while (!Debug_Lib_Suppression_Sites__.compare_exchange_weak(head, &site, ::std::memory_order_release, ::std::memory_order_relaxed));
+}
+
+void DebugLib::ReportSuppressed(::std::int64_t now)
+{
+	::std::int64_t next = Debug_Lib_Suppression_Summary_Time__.load(::std::memory_order_relaxed);
+	if (now < next || !Debug_Lib_Suppression_Summary_Time__.compare_exchange_strong(next,
+		now + static_cast<::std::int64_t>(DEBUG_LIB_SUPPRESSION_SUMMARY_PERIOD) * 1000000, ::std::memory_order_relaxed))
+		return;
+	WriteSuppressionSummary();
+}
+
+#endif /* DEBUG */
+
+#if defined(DEBUG) && defined(DEBUG_LIB_METRICS)
+
+namespace DebugLib
+{
+	// Zero initialized before any dynamic initialization
+	::std::atomic<::std::int64_t> DEBUG_LIB_METRIC_GAUGES_VAR_NAME[DEBUG_LIB_METRICS_GAUGES + 1];
+
+	/**
+	 *	@brief Registered metrics and shards of all threads.
+	 *	Shards are never freed: shard of a finished thread is given to the next new thread with its values,
+	 *	as reported values are sums over all shards.
+	 */
+	class MetricRegistry
+	{
+		struct Metric
+		{
+			const char* name;
+			MetricKind kind;
+			::std::uint32_t id;
+			::std::uint64_t reported;	//!< Value of counter in the previous snapshot
+		};
+
+		/**
+		 *	@brief Values of one metric taken for a snapshot.
+		 */
+		struct Sample
+		{
+			const char* name;
+			MetricKind kind;
+			::std::uint64_t value;		//!< Counter value, gauge value or count of histogram values
+			::std::uint64_t delta;		//!< Counter change or sum of histogram values
+			::std::uint64_t p50;
+			::std::uint64_t p90;
+			::std::uint64_t p99;
+			::std::uint64_t max;
+		};
+
+	public:
+
+		MetricRegistry() : slots(0), gauges(0), overflow(0) {}
+
+		::std::uint32_t add(const char* name, MetricKind kind)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			for (const Metric& metric : metrics)
+				if (metric.kind == kind && !::std::strcmp(metric.name, name))
+					return metric.id;
+			::std::uint32_t id;
+			if (kind == MetricKind::Gauge)
+			{
+				if (gauges == DEBUG_LIB_METRICS_GAUGES)
+					return ++overflow, DEBUG_LIB_METRICS_GAUGES;
+				id = gauges++;
+			}
+			else
+			{
+				const ::std::uint32_t size = kind == MetricKind::Histogram ? DEBUG_LIB_HISTOGRAM_SLOTS : 1;
+				if (DEBUG_LIB_METRICS_SLOTS - slots < size)
+					return ++overflow, DEBUG_LIB_METRICS_SLOTS;
+				id = slots;
+				slots += size;
+			}
+			metrics.push_back(Metric{ name, kind, id, 0 });
+			return id;
+		}
+
+		MetricShard* acquire()
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			for (MetricShard* shard : shards)
+			{
+				bool used = false;
+				if (shard->used.compare_exchange_strong(used, true))
+					return shard;
+			}
+			shards.push_back(new MetricShard);
+			return shards.back();
+		}
+
+		/**
+		 *	@brief Writes one user level message for every metric with its values as a JSON object.
+		 *	Values are summed under the registry mutex, messages are written after it is released.
+		 */
+		void report()
+		{
+			::std::vector<Sample> samples;
+			::std::size_t lost;
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				samples.reserve(metrics.size());
+				for (Metric& metric : metrics)
+					samples.push_back(sample(metric));
+				lost = overflow;
+			}
+			for (const Sample& sample : samples)
+				WriteLibraryMessage(Level::User, "", [&sample](LibraryStream& out)
+				{
+					out << "METRICS::" << sample.name << DEBUG_LIB_NEXT_LINE;
+					switch (sample.kind)
+					{
+					case MetricKind::Counter:
+						WriteKeyValues(out, "type", "counter", "value", sample.value, "delta", sample.delta);
+						break;
+					case MetricKind::Gauge:
+						WriteKeyValues(out, "type", "gauge", "value", static_cast<::std::int64_t>(sample.value));
+						break;
+					default:
+						WriteKeyValues(out, "type", "histogram", "count", sample.value, "sum", sample.delta,
+							"p50", sample.p50, "p90", sample.p90, "p99", sample.p99, "max", sample.max);
+					}
+					out << DEBUG_LIB_NEXT_LINE;
+				});
+			if (lost)
+				WriteLibraryMessage(Level::User, "", [lost](LibraryStream& out)
+				{
+					out << "METRICS::not registered" << DEBUG_LIB_NEXT_LINE
+						<< "\tmetrics that did not fit into DEBUG_LIB_METRICS_SLOTS or DEBUG_LIB_METRICS_GAUGES: " << lost << DEBUG_LIB_NEXT_LINE;
+				});
+		}
+
+	private:
+
+		::std::uint64_t sum(::std::uint32_t slot) const
+		{
+			::std::uint64_t total = 0;
+			for (const MetricShard* shard : shards)
+				total += shard->slots[slot].load(::std::memory_order_relaxed);
+			return total;
+		}
+
+		Sample sample(Metric& metric) const
+		{
+			Sample result = Sample();
+			result.name = metric.name;
+			result.kind = metric.kind;
+			if (metric.kind == MetricKind::Counter)
+			{
+				result.value = sum(metric.id);
+				result.delta = result.value - metric.reported;
+				metric.reported = result.value;
+			}
+			else if (metric.kind == MetricKind::Gauge)
+				result.value = static_cast<::std::uint64_t>(DEBUG_LIB_METRIC_GAUGES_VAR_NAME[metric.id].load(::std::memory_order_relaxed));
+			else
+			{
+				// Percentiles are reported as upper bounds of buckets that hold them
+				::std::uint64_t buckets[DEBUG_LIB_HISTOGRAM_SLOTS - 1];
+				for (unsigned bucket = 0; bucket < DEBUG_LIB_HISTOGRAM_SLOTS - 1; ++bucket)
+				{
+					buckets[bucket] = sum(metric.id + bucket);
+					result.value += buckets[bucket];
+				}
+				result.delta = sum(metric.id + DEBUG_LIB_HISTOGRAM_SLOTS - 1);
+				result.p50 = HistogramPercentile(buckets, result.value, 50);
+				result.p90 = HistogramPercentile(buckets, result.value, 90);
+				result.p99 = HistogramPercentile(buckets, result.value, 99);
+				result.max = HistogramPercentile(buckets, result.value, 100);
+			}
+			return result;
+		}
+
+		::std::mutex mutex;
+		::std::vector<Metric> metrics;
+		::std::vector<MetricShard*> shards;
+		::std::uint32_t slots;		//!< Count of shard slots given to metrics
+		::std::uint32_t gauges;		//!< Count of gauges given to metrics
+		::std::size_t overflow;		//!< Count of metrics that did not fit
+
+		MetricRegistry(const MetricRegistry&) = delete;
+		MetricRegistry& operator=(const MetricRegistry&) = delete;
+	};
+
+	static MetricRegistry& GetMetricRegistry()
+	{
+		static MetricRegistry registry;
+		return registry;
+	}
+
+	/**
+	 *	@brief Background thread that writes a snapshot of metrics every DEBUG_LIB_METRICS_PERIOD.
+	 *	The last snapshot is written on static destruction.
+	 */
+	class MetricReporter
+	{
+	public:
+
+		MetricReporter() : stop(false)
+		{
+#	if DEBUG_LIB_METRICS_PERIOD
+			worker = ::std::thread(&MetricReporter::run, this);
+#	endif
+		}
+
+		~MetricReporter()
+		{
+#	if DEBUG_LIB_METRICS_PERIOD
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_one();
+			worker.join();
+#	endif
+			GetMetricRegistry().report();
+		}
+
+	private:
+
+		void run()
+		{
+			::std::unique_lock<::std::mutex> lock(mutex);
+			while (!wake.wait_for(lock, ::std::chrono::milliseconds(DEBUG_LIB_METRICS_PERIOD), [this] { return stop; }))
+			{
+				lock.unlock();
+				GetMetricRegistry().report();
+				lock.lock();
+			}
+		}
+
+		bool stop;
+		::std::mutex mutex;
+		::std::condition_variable wake;
+		::std::thread worker;
+
+		MetricReporter(const MetricReporter&) = delete;
+		MetricReporter& operator=(const MetricReporter&) = delete;
+	};
+
+	/**
+	 *	@brief Gives shard of thread back to the registry when the thread finishes.
+	 */
+	struct MetricShardOwner
+	{
+		MetricShardOwner() : shard(nullptr) {}
+
+		~MetricShardOwner()
+		{
+			if (shard)
+				shard->used.store(false);
+		}
+
+		MetricShard* shard;
+	};
+
+	/**
+	 *	@brief Starts the reporter on first call.
+	 *	Output objects used by messages are created first so they are destroyed after the last snapshot.
+	 */
+	static void StartMetricReporter()
+	{
+#	ifdef DEBUG_LIB_ASYNC
+		GetAsyncWriter();
+#	endif
+		static MetricReporter reporter;
+		(void)reporter;
+	}
+}
+
+::std::uint32_t DebugLib::RegisterMetric(const char* name, DebugLib::MetricKind kind)
+{
+	// Registry is created before the reporter so it outlives the last snapshot
+	const ::std::uint32_t id = GetMetricRegistry().add(name, kind);
+	StartMetricReporter();
+	return id;
+}
+
+DebugLib::MetricShard* DebugLib::AcquireMetricShard()
+{
+	static thread_local MetricShardOwner owner;
+	return owner.shard = GetMetricRegistry().acquire();
+}
+
+#endif /* DEBUG && DEBUG_LIB_METRICS */
+
+#if defined(DEBUG) && defined(DEBUG_LIB_TRACE)
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Trace buffers of all threads.
+	 *	Buffers are never freed: buffer of a finished thread is given to the next new thread,
+	 *	so events of both threads have the same thread identifier.
+	 */
+	class TraceRegistry
+	{
+	public:
+
+		TraceRegistry() {}
+
+		TraceBuffer* acquire()
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			for (TraceBuffer* buffer : buffers)
+			{
+				bool used = false;
+				if (buffer->used.compare_exchange_strong(used, true))
+					return buffer;
+			}
+			buffers.push_back(new TraceBuffer(static_cast<::std::uint32_t>(buffers.size() + 1)));
+			return buffers.back();
+		}
+
+		/**
+		 *	@brief Copies the list of buffers, so events are exported without holding the registry mutex.
+		 */
+		void list(::std::vector<TraceBuffer*>& out)
+		{
+			::std::lock_guard<::std::mutex> lock(mutex);
+			out = buffers;
+		}
+
+	private:
+		::std::mutex mutex;
+		::std::vector<TraceBuffer*> buffers;
+
+		TraceRegistry(const TraceRegistry&) = delete;
+		TraceRegistry& operator=(const TraceRegistry&) = delete;
+	};
+
+	// Timestamp counter value taken on static initialization : origin of exported timestamps
+	static const ::std::uint64_t Debug_Lib_Trace_Start__ = ReadTimestampCounter();
+
+	static TraceRegistry& GetTraceRegistry()
+	{
+		static TraceRegistry registry;
+		return registry;
+	}
+
+	/**
+	 *	@brief Background thread that drains trace buffers every DEBUG_LIB_TRACE_PERIOD
+	 *	and appends their events to DEBUG_LIB_TRACE_FILE_NAME as Chrome trace events.
+	 *	File is a JSON array of complete ("X") events with timestamps in microseconds since program start.
+	 *	Array is closed on static destruction after the last export. Trace viewers also load files
+	 *	that were not closed, so the trace of a crashed process is usable too.
+	 */
+	class TraceWriter
+	{
+	public:
+
+		TraceWriter() :
+			file(DEBUG_LIB_TRACE_FILE_NAME, ::std::fstream::trunc | ::std::fstream::out),
+			events(0),
+			dropped(0),
+			stop(false)
+		{
+			file << '[';
+#	if DEBUG_LIB_TRACE_PERIOD
+			worker = ::std::thread(&TraceWriter::run, this);
+#	endif
+		}
+
+		~TraceWriter()
+		{
+#	if DEBUG_LIB_TRACE_PERIOD
+			{
+				::std::lock_guard<::std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_one();
+			worker.join();
+#	endif
+			drain();
+			file << "\n]\n";
+			file.close();
+			if (dropped)
+				WriteLibraryMessage(Level::User, "", [this](LibraryStream& out)
+				{
+					out << "TRACE::dropped events" << DEBUG_LIB_NEXT_LINE
+						<< "\ttrace events that did not fit into DEBUG_LIB_TRACE_BUFFER_SIZE: " << dropped << DEBUG_LIB_NEXT_LINE;
+				});
+		}
+
+	private:
+
+		void run()
+		{
+			::std::unique_lock<::std::mutex> lock(mutex);
+			while (!wake.wait_for(lock, ::std::chrono::milliseconds(DEBUG_LIB_TRACE_PERIOD), [this] { return stop; }))
+			{
+				lock.unlock();
+				drain();
+				lock.lock();
+			}
+		}
+
+		/**
+		 *	@brief Exports all events added to the buffers so far and frees their places.
+		 */
+		void drain()
+		{
+			GetTraceRegistry().list(buffers);
+			::std::uint64_t lost = 0;
+			for (TraceBuffer* buffer : buffers)
+			{
+				::std::uint64_t position = buffer->tail.load(::std::memory_order_relaxed);
+				const ::std::uint64_t head = buffer->head.load(::std::memory_order_acquire);
+				for (; position != head; ++position)
+					write(buffer->events[position & (DEBUG_LIB_TRACE_BUFFER_SIZE - 1)], buffer->thread);
+				buffer->tail.store(head, ::std::memory_order_release);
+				lost += buffer->dropped.load(::std::memory_order_relaxed);
+			}
+			dropped = lost;
+			file.flush();
+		}
+
+		void write(const TraceEvent& event, ::std::uint32_t thread)
+		{
+			const ::std::uint64_t start = clock.toWallTime(Debug_Lib_Trace_Start__);
+			const ::std::uint64_t begin = clock.toWallTime(event.begin);
+			const ::std::uint64_t end = clock.toWallTime(event.end);
+			KeyValueWriter fields;
+			fields.add("name", 4, event.name);
+			fields.add("ph", 2, "X");
+			fields.add("pid", 3, 1);
+			fields.add("tid", 3, thread);
+			fields.add("ts", 2, static_cast<double>(static_cast<::std::int64_t>(begin - start)) / 1000.0);
+			fields.add("dur", 3, static_cast<double>(end > begin ? end - begin : 0) / 1000.0);
+			file << (events++ ? ",\n" : "\n") << fields.finish();
+		}
+
+		TimestampClock clock;
+		::std::ofstream file;
+		::std::uint64_t events;		//!< Count of exported events
+		::std::uint64_t dropped;	//!< Count of events dropped by all threads
+		::std::vector<TraceBuffer*> buffers;
+		bool stop;
+		::std::mutex mutex;
+		::std::condition_variable wake;
+		::std::thread worker;
+
+		TraceWriter(const TraceWriter&) = delete;
+		TraceWriter& operator=(const TraceWriter&) = delete;
+	};
+
+	/**
+	 *	@brief Gives buffer of thread back to the registry when the thread finishes.
+	 */
+	struct TraceBufferOwner
+	{
+		TraceBufferOwner() : buffer(nullptr) {}
+
+		~TraceBufferOwner()
+		{
+			if (buffer)
+				buffer->used.store(false);
+		}
+
+		TraceBuffer* buffer;
+	};
+
+	/**
+	 *	@brief Starts the writer on first call.
+	 *	Output objects used by messages are created first so they are destroyed after the last export.
+	 */
+	static void StartTraceWriter()
+	{
+#	ifdef DEBUG_LIB_ASYNC
+		GetAsyncWriter();
+#	endif
+		static TraceWriter writer;
+		(void)writer;
+	}
+}
+
+DebugLib::TraceBuffer* DebugLib::AcquireTraceBuffer()
+{
+	static thread_local TraceBufferOwner owner;
+	// Registry is created before the writer so it outlives the last export
+	owner.buffer = GetTraceRegistry().acquire();
+	StartTraceWriter();
+	return owner.buffer;
+}
+
+#endif /* DEBUG && DEBUG_LIB_TRACE */
+
+#ifdef DEBUG_LIB_CRASH_DRAIN
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Fatal signals which handlers drain output.
+	 */
+	static const int Debug_Lib_Crash_Signals__[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+	static const ::std::size_t Debug_Lib_Crash_Signal_Count__ = sizeof(Debug_Lib_Crash_Signals__) / sizeof(Debug_Lib_Crash_Signals__[0]);
+
+	/**
+	 *	@brief Installs handlers of fatal signals that drain output and then pass the signal on.
+	 *	Handlers are installed on static initialization. Previous handlers are restored on static
+	 *	destruction and by the handler itself before the signal is raised again, so the default action
+	 *	(or a handler installed before DebugLib) terminates the process.
+	 */
+	class CrashHandlers
+	{
+	public:
+
+		CrashHandlers() : stackInstalled(false)
+		{
+#	if DEBUG_LIB_CRASH_STACK_SIZE
+			// Stack overflow can be handled only on another stack
+			stack_t current;
+			if (sigaltstack(nullptr, &current) == 0 && (current.ss_flags & SS_DISABLE))
+			{
+				stack_t alternate;
+				::std::memset(&alternate, 0, sizeof(alternate));
+				alternate.ss_sp = stack;
+				alternate.ss_size = sizeof(stack);
+				stackInstalled = sigaltstack(&alternate, nullptr) == 0;
+			}
+#	endif
+			struct sigaction action;
+			::std::memset(&action, 0, sizeof(action));
+			action.sa_sigaction = &CrashHandlers::handle;
+			action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+			sigemptyset(&action.sa_mask);
+			for (::std::size_t i = 0; i < Debug_Lib_Crash_Signal_Count__; ++i)
+				sigaction(Debug_Lib_Crash_Signals__[i], &action, &previous[i]);
+		}
+
+		~CrashHandlers()
+		{
+			for (::std::size_t i = 0; i < Debug_Lib_Crash_Signal_Count__; ++i)
+				sigaction(Debug_Lib_Crash_Signals__[i], &previous[i], nullptr);
+#	if DEBUG_LIB_CRASH_STACK_SIZE
+			if (stackInstalled)
+			{
+				stack_t disabled;
+				::std::memset(&disabled, 0, sizeof(disabled));
+				disabled.ss_flags = SS_DISABLE;
+				sigaltstack(&disabled, nullptr);
+			}
+#	endif
+		}
+
+	private:
+
+		static void handle(int signal, siginfo_t*, void*);
+
+		static struct sigaction previous[sizeof(Debug_Lib_Crash_Signals__) / sizeof(Debug_Lib_Crash_Signals__[0])];
+		bool stackInstalled;
+#	if DEBUG_LIB_CRASH_STACK_SIZE
+		alignas(16) char stack[DEBUG_LIB_CRASH_STACK_SIZE];
+#	endif
+
+		CrashHandlers(const CrashHandlers&) = delete;
+		CrashHandlers& operator=(const CrashHandlers&) = delete;
+	};
+
+	struct sigaction CrashHandlers::previous[sizeof(Debug_Lib_Crash_Signals__) / sizeof(Debug_Lib_Crash_Signals__[0])];
+
+	void CrashHandlers::handle(int signal, siginfo_t*, void*)
+	{
+		const int error = errno;
+		DrainPendingOutput();
+		for (::std::size_t i = 0; i < Debug_Lib_Crash_Signal_Count__; ++i)
+			if (Debug_Lib_Crash_Signals__[i] == signal)
+				sigaction(signal, &previous[i], nullptr);
+		// Signal stays blocked until the handler returns : then the restored action takes place
+		raise(signal);
+		errno = error;
+	}
+}
+
+// Installed after the output objects are created and removed before they are destroyed
+static DebugLib::CrashHandlers Debug_Lib_Crash_Handlers__;
+
+void DebugLib::DrainPendingOutput()
+{
+	int expected = 0;
+	if (!Debug_Lib_Drain_State__.compare_exchange_strong(expected, 1))
+	{
+		// Output is drained by another thread : process must not terminate before it finishes
+		const timespec pause = { 0, 1000000 };
+		while (Debug_Lib_Drain_State__.load() != 2)
+			nanosleep(&pause, nullptr);
+		return;
+	}
+#	ifdef DEBUG_LIB_ASYNC
+	const AsyncWriter* writer = Debug_Lib_Crash_Writer__.load();
+	if (writer)
+		writer->settle();
+#	endif
+	// Output is drained in order of its age : file buffer, batch of the writer, queue
+#	ifdef DEBUG_LIB_FILE_LOG
+	const int fd = Debug_Lib_Log_Buffer__.descriptor();
+	Debug_Lib_Log_Buffer__.drain();
+#	else
+	const int fd = STDERR_FILENO;
+#	endif
+#	ifdef DEBUG_LIB_ASYNC
+	if (writer)
+		writer->drain(fd);
+#	else
+	(void)fd;
+#	endif
+	Debug_Lib_Drain_State__.store(2);
+}
+
+#endif /* DEBUG_LIB_CRASH_DRAIN */
@@ -0,0 +1,565 @@
+#pragma once
+#ifndef DEBUG_LIB_BINARY_RECORD_HPP__
+#define DEBUG_LIB_BINARY_RECORD_HPP__ "1.0.0@cBinaryRecord.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains implementation of binary message encoding used by DebugLib binary log.
+*		Encoding and decoding are kept together so the offline tools stay in sync with the library.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/**
+*	Binary log layout (all integers are stored in native byte order):
+*		Session frame : 'S' u32(version)
+*		Site frame    : 'D' u32(site id) u32(length) char[length](header text)
+*		Message frame : 'M' u32(site id) u8(level) u32(length) byte[length](arguments)
+*		Time frame    : 'T' u64(nanoseconds since epoch, UTC)
+*	Every argument is stored as one tag byte followed by raw bytes of the value:
+*		'b' u8 | 'c' char | 'i' u8(size) signed[size] | 'u' u8(size) unsigned[size]
+*		'f' float | 'd' double | 'p' u64 | 's' u32(length) char[length]
+*	Key-value fields of one DEBUG_KV call are stored as one argument:
+*		'o' u8(count) followed by count pairs of string key argument and value argument
+*	Session frame is written once per process run, site frames are written in order of site
+*	identifiers before the first message frame that refers to them. Time frame is written before every
+*	message frame if timestamps are enabled and refers to the next message.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+/// DebugLib
+#include "cRecord.hpp"
+#include "cKeyValue.hpp"
+#include "cTimestamp.hpp"
+
+//	Version of binary log layout
+#define DEBUG_LIB_BINARY_VERSION 1
+
+namespace DebugLib
+{
+	/**
+	 *	Defines the frame kinds of binary log.
+	 */
+	enum BinaryFrame : char
+	{
+		SessionFrame = 'S',	//!< Start of the output of one process run
+		SiteFrame = 'D',	//!< Definition of call site header
+		MessageFrame = 'M',	//!< One message
+		TimeFrame = 'T'		//!< Wall time of the next message
+	};
+
+	/**
+	 *	Defines the argument tags of binary log.
+	 */
+	enum BinaryTag : char
+	{
+		BoolTag = 'b',		//!< bool
+		CharTag = 'c',		//!< char, signed char, unsigned char
+		SignedTag = 'i',	//!< Signed integer of given size
+		UnsignedTag = 'u',	//!< Unsigned integer of given size
+		FloatTag = 'f',		//!< float
+		DoubleTag = 'd',	//!< double and long double
+		PointerTag = 'p',	//!< Any non character pointer
+		StringTag = 's',	//!< C-string, std::string or value formatted with operator<<
+		ObjectTag = 'o'		//!< Key-value fields of one DEBUG_KV call
+	};
+
+	/**
+	 *	@brief Encoder that captures message arguments as tagged raw bytes into a Record.
+	 *	Provides operator<< for the same set of values as a standard stream so output macros set
+	 *	may be used unchanged. Values of other types are formatted to text on the calling thread
+	 *	and stored as strings. Stream manipulators are ignored. Arguments that do not fit are discarded.
+	 */
+	class BinaryRecordStream
+	{
+	public:
+
+		BinaryRecordStream() : record(), full(false) {}
+
+		/**
+		 *	@brief Starts capturing of a new message.
+		 *	@param level Level of the new message.
+		 *	@param site Identifier of message call site.
+		 *	@return Reference to this stream.
+		 */
+		BinaryRecordStream& open(Level level, ::std::uint32_t site)
+		{
+			record.size = 0;
+			record.level = static_cast<int>(level);
+			record.site = site;
+			record.header = "";
+#ifdef DEBUG_LIB_TIMESTAMP
+			record.ticks = ReadTimestampCounter();
+#endif
+			full = false;
+			return *this;
+		}
+
+		/**
+		 *	@brief Ends capturing of current message.
+		 *	@return Reference to the captured record.
+		 */
+		Record& close()
+		{
+			return record;
+		}
+
+		BinaryRecordStream& operator<<(bool value) { return put(BoolTag, static_cast<::std::uint8_t>(value)); }
+		BinaryRecordStream& operator<<(char value) { return put(CharTag, value); }
+		BinaryRecordStream& operator<<(signed char value) { return put(CharTag, static_cast<char>(value)); }
+		BinaryRecordStream& operator<<(unsigned char value) { return put(CharTag, static_cast<char>(value)); }
+		BinaryRecordStream& operator<<(short value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(unsigned short value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(int value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(unsigned int value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(long value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(unsigned long value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(long long value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(unsigned long long value) { return putInteger(value); }
+		BinaryRecordStream& operator<<(float value) { return put(FloatTag, value); }
+		BinaryRecordStream& operator<<(double value) { return put(DoubleTag, value); }
+		BinaryRecordStream& operator<<(long double value) { return put(DoubleTag, static_cast<double>(value)); }
+		BinaryRecordStream& operator<<(const char* value) { return value ? putString(value, ::std::strlen(value)) : *this; }
+		BinaryRecordStream& operator<<(char* value) { return *this << static_cast<const char*>(value); }
+		BinaryRecordStream& operator<<(const void* value) { return put(PointerTag, static_cast<::std::uint64_t>(reinterpret_cast<::std::uintptr_t>(value))); }
+		BinaryRecordStream& operator<<(::std::ostream& (*)(::std::ostream&)) { return *this; }
+		BinaryRecordStream& operator<<(::std::ios_base& (*)(::std::ios_base&)) { return *this; }
+
+		template < typename T >
+		BinaryRecordStream& operator<<(T* value)
+		{
+			return *this << static_cast<const void*>(value);
+		}
+
+		template < typename Traits, typename Alloc >
+		BinaryRecordStream& operator<<(const ::std::basic_string<char, Traits, Alloc>& value)
+		{
+			return putString(value.data(), value.size());
+		}
+
+		template < typename T >
+		BinaryRecordStream& operator<<(const T& value)
+		{
+			static thread_local RecordStream scratch;
+			scratch.open(static_cast<Level>(record.level)) << value;
+			const Record& text = scratch.close();
+			return putString(text.data, text.size);
+		}
+
+		/**
+		 *	@brief Stores fields of one DEBUG_KV call as one object argument.
+		 *	Field that does not fit is discarded with all following arguments of the message.
+		 *	@param fields Pairs of C-string key and value.
+		 *	@return Reference to this stream.
+		 */
+		template < typename... Fields >
+		BinaryRecordStream& putKeyValues(const Fields&... fields)
+		{
+			static_assert(sizeof...(Fields) % 2 == 0, "DEBUG_KV expects pairs of key and value");
+			static_assert(sizeof...(Fields) / 2 <= 0xFF, "DEBUG_KV accepts at most 255 fields");
+			if (reserve(2))
+			{
+				record.data[record.size++] = ObjectTag;
+				record.data[record.size++] = 0;
+				putFields(record.size - 1, fields...);
+			}
+			return *this;
+		}
+
+	private:
+
+		void putFields(::std::size_t) {}
+
+		template < typename T, typename... Fields >
+		void putFields(::std::size_t count, const char* key, const T& value, const Fields&... fields)
+		{
+			const ::std::size_t mark = record.size;
+			putString(key ? key : "", key ? ::std::strlen(key) : 0);
+			*this << value;
+			if (full)
+			{
+				record.size = mark;
+				return;
+			}
+			record.data[count] = static_cast<char>(static_cast<unsigned char>(record.data[count]) + 1);
+			putFields(count, fields...);
+		}
+
+		bool reserve(::std::size_t count)
+		{
+			if (full || record.size + count > DEBUG_LIB_RECORD_SIZE)
+				full = true;
+			return !full;
+		}
+
+		void append(const void* data, ::std::size_t count)
+		{
+			::std::memcpy(record.data + record.size, data, count);
+			record.size += count;
+		}
+
+		template < typename T >
+		BinaryRecordStream& put(BinaryTag tag, T value)
+		{
+			if (reserve(1 + sizeof(T)))
+			{
+				record.data[record.size++] = tag;
+				append(&value, sizeof(T));
+			}
+			return *this;
+		}
+
+		template < typename T >
+		BinaryRecordStream& putInteger(T value)
+		{
+			if (reserve(2 + sizeof(T)))
+			{
+				record.data[record.size++] = ::std::is_signed<T>::value ? SignedTag : UnsignedTag;
+				record.data[record.size++] = static_cast<char>(sizeof(T));
+				append(&value, sizeof(T));
+			}
+			return *this;
+		}
+
+		BinaryRecordStream& putString(const char* data, ::std::size_t length)
+		{
+			const ::std::uint32_t size = static_cast<::std::uint32_t>(length);
+			if (reserve(1 + sizeof(size) + length))
+			{
+				record.data[record.size++] = StringTag;
+				append(&size, sizeof(size));
+				append(data, length);
+			}
+			return *this;
+		}
+
+		Record record;
+		bool full;
+
+		BinaryRecordStream(const BinaryRecordStream&) = delete;
+		BinaryRecordStream& operator=(const BinaryRecordStream&) = delete;
+	};
+
+	/**
+	 *	@brief Starts a new binary message in the stream of calling thread.
+	 *	@param level Level of the new message.
+	 *	@param site Identifier of message call site obtained from RegisterSite.
+	 *	@return Reference to the binary record stream of calling thread.
+	 */
+	inline BinaryRecordStream& OpenBinaryRecord(Level level, ::std::uint32_t site)
+	{
+		static thread_local BinaryRecordStream stream;
+		return stream.open(level, site);
+	}
+
+	/**
+	 *	@brief Ends the message started by OpenBinaryRecord and passes it to the output.
+	 *	@param stream Stream returned by OpenBinaryRecord.
+	 */
+	DEBUG_LIB_COLD_FUNCTION void CommitRecord(BinaryRecordStream& stream);
+
+	/**
+	 *	@brief Writes fields as one object argument to the binary record of current message.
+	 *	@param out Binary record stream of current message (See: DEBUG_LIB_MESSAGE_OUT).
+	 *	@param fields Pairs of C-string key and value.
+	 *	@return Reference to out.
+	 */
+	template < typename... Fields >
+	BinaryRecordStream& WriteKeyValues(BinaryRecordStream& out, const Fields&... fields)
+	{
+		return out.putKeyValues(fields...);
+	}
+
+	/**
+	 *	@brief Registers a message call site.
+	 *	Called once per call site, the header is written to the log before the first message of the site.
+	 *	@param header Static C-string with the first line of message, may be empty.
+	 *	@return Identifier of call site.
+	 */
+	::std::uint32_t RegisterSite(const char* header);
+
+	/**
+	 *	@brief Decodes one argument of a message.
+	 *	Object arguments are not decoded by this function (See: FormatBinaryArguments).
+	 *	@param data Position of argument tag, moved past the argument on success.
+	 *	@param end End of encoded arguments.
+	 *	@param visitor Called with decoded value of one of types: bool, char, long long, unsigned long long,
+	 *	float, double, const void*, or with pointer to characters and their count for strings.
+	 *	@return true if argument was decoded, false if data is malformed.
+	 */
+	template < typename Visitor >
+	bool ReadBinaryArgument(const char*& data, const char* end, Visitor& visitor)
+	{
+		if (data == end)
+			return false;
+		const char tag = *data++;
+		::std::size_t length = 0;
+		switch (tag)
+		{
+		case BoolTag: length = 1; break;
+		case CharTag: length = 1; break;
+		case SignedTag:
+		case UnsignedTag:
+			if (data == end)
+				return false;
+			length = static_cast<unsigned char>(*data++);
+			if (length != 1 && length != 2 && length != 4 && length != 8)
+				return false;
+			break;
+		case FloatTag: length = sizeof(float); break;
+		case DoubleTag: length = sizeof(double); break;
+		case PointerTag: length = sizeof(::std::uint64_t); break;
+		case StringTag:
+		{
+			::std::uint32_t count;
+			if (end - data < static_cast<::std::ptrdiff_t>(sizeof(count)))
+				return false;
+			::std::memcpy(&count, data, sizeof(count));
+			data += sizeof(count);
+			length = count;
+			break;
+		}
+		default:
+			return false;
+		}
+		if (end - data < static_cast<::std::ptrdiff_t>(length))
+			return false;
+		switch (tag)
+		{
+		case BoolTag: visitor(*data != 0); break;
+		case CharTag: visitor(*data); break;
+		case SignedTag:
+		{
+			::std::int64_t value = 0;
+			switch (length)
+			{
+			case 1: { ::std::int8_t v; ::std::memcpy(&v, data, 1); value = v; break; }
+			case 2: { ::std::int16_t v; ::std::memcpy(&v, data, 2); value = v; break; }
+			case 4: { ::std::int32_t v; ::std::memcpy(&v, data, 4); value = v; break; }
+			default: ::std::memcpy(&value, data, 8);
+			}
+			visitor(static_cast<long long>(value));
+			break;
+		}
+		case UnsignedTag:
+		{
+			::std::uint64_t value = 0;
+			switch (length)
+			{
+			case 1: { ::std::uint8_t v; ::std::memcpy(&v, data, 1); value = v; break; }
+			case 2: { ::std::uint16_t v; ::std::memcpy(&v, data, 2); value = v; break; }
+			case 4: { ::std::uint32_t v; ::std::memcpy(&v, data, 4); value = v; break; }
+			default: ::std::memcpy(&value, data, 8);
+			}
+			visitor(static_cast<unsigned long long>(value));
+			break;
+		}
+		case FloatTag: { float v; ::std::memcpy(&v, data, sizeof(v)); visitor(v); break; }
+		case DoubleTag: { double v; ::std::memcpy(&v, data, sizeof(v)); visitor(v); break; }
+		case PointerTag:
+		{
+			::std::uint64_t v;
+			::std::memcpy(&v, data, sizeof(v));
+			visitor(reinterpret_cast<const void*>(static_cast<::std::uintptr_t>(v)));
+			break;
+		}
+		default: visitor(data, length);
+		}
+		data += length;
+		return true;
+	}
+
+	/**
+	 *	@brief Sends decoded arguments to a standard stream.
+	 */
+	struct BinaryStreamVisitor
+	{
+		::std::ostream& out;
+
+		template < typename T >
+		void operator()(const T& value) { out << value; }
+		void operator()(const char* data, ::std::size_t length) { out.write(data, static_cast<::std::streamsize>(length)); }
+	};
+
+	/**
+	 *	@brief Adds decoded value as one field of key-value object.
+	 */
+	struct BinaryFieldVisitor
+	{
+		KeyValueWriter& writer;
+		const char* key;
+		::std::size_t keyLength;
+
+		template < typename T >
+		void operator()(const T& value) { writer.add(key, keyLength, value); }
+		void operator()(const char* data, ::std::size_t length) { writer.addString(key, keyLength, data, length); }
+	};
+
+	/**
+	 *	@brief Captures decoded string argument.
+	 */
+	struct BinaryStringVisitor
+	{
+		const char* data;
+		::std::size_t length;
+
+		template < typename T >
+		void operator()(const T&) {}
+		void operator()(const char* value, ::std::size_t count) { data = value; length = count; }
+	};
+
+	/**
+	 *	@brief Formats encoded arguments of one message as if they were sent to a standard stream.
+	 *	Key-value fields are formatted to the same JSON object as in text output.
+	 *	@param out Output stream.
+	 *	@param data Encoded arguments.
+	 *	@param size Count of bytes in data.
+	 *	@return true if all arguments were decoded, false if data is malformed.
+	 */
+	inline bool FormatBinaryArguments(::std::ostream& out, const char* data, ::std::size_t size)
+	{
+		const char* const end = data + size;
+		BinaryStreamVisitor stream = { out };
+		while (data < end)
+		{
+			if (*data != ObjectTag)
+			{
+				if (!ReadBinaryArgument(data, end, stream))
+					return false;
+				continue;
+			}
+			if (end - data < 2)
+				return false;
+			const unsigned count = static_cast<unsigned char>(data[1]);
+			data += 2;
+			KeyValueWriter writer;
+			for (unsigned i = 0; i < count; ++i)
+			{
+				BinaryStringVisitor key = { nullptr, 0 };
+				if (data == end || *data != StringTag || !ReadBinaryArgument(data, end, key))
+					return false;
+				BinaryFieldVisitor field = { writer, key.data, key.length };
+				if (data == end || *data == ObjectTag || !ReadBinaryArgument(data, end, field))
+					return false;
+			}
+			out << writer.finish();
+		}
+		return true;
+	}
+
+	/**
+	 *	@brief Converts all frames of binary log to the text layout of DebugLib.
+	 *	Time frames are written as "[...] " prefix of the next message.
+	 *	@param out Output stream.
+	 *	@param data Content of binary log.
+	 *	@param size Count of bytes in data.
+	 *	@return Offset of the first malformed frame or size if all frames are valid (frames before it are written).
+	 */
+	inline ::std::size_t DecodeBinaryLog(::std::ostream& out, const char* data, ::std::size_t size)
+	{
+		const char* const begin = data;
+		const char* const end = data + size;
+		::std::vector<::std::string> sites;
+		TimestampFormatter formatter;
+		char stamp[DEBUG_LIB_TIMESTAMP_TEXT_SIZE];
+		::std::size_t stampSize = 0;
+		const auto read = [&data, end](void* value, ::std::size_t count)
+		{
+			if (static_cast<::std::size_t>(end - data) < count)
+				return false;
+			::std::memcpy(value, data, count);
+			data += count;
+			return true;
+		};
+		while (data < end)
+		{
+			const char* const frame = data;
+			const char kind = *data++;
+			switch (kind)
+			{
+			case SessionFrame:
+			{
+				::std::uint32_t version;
+				if (!read(&version, sizeof(version)) || version != DEBUG_LIB_BINARY_VERSION)
+					return static_cast<::std::size_t>(frame - begin);
+				// Site identifiers are restarted by every process run
+				sites.clear();
+				break;
+			}
+			case SiteFrame:
+			{
+				// Sites are defined in order of their identifiers
+				::std::uint32_t site, length;
+				if (!read(&site, sizeof(site)) || !read(&length, sizeof(length)) || site > sites.size() ||
+					static_cast<::std::size_t>(end - data) < length)
+					return static_cast<::std::size_t>(frame - begin);
+				if (site == sites.size())
+					sites.emplace_back();
+				sites[site].assign(data, length);
+				data += length;
+				break;
+			}
+			case MessageFrame:
+			{
+				::std::uint32_t site, length;
+				::std::uint8_t level;
+				if (!read(&site, sizeof(site)) || !read(&level, sizeof(level)) || !read(&length, sizeof(length)) ||
+					static_cast<::std::size_t>(end - data) < length)
+					return static_cast<::std::size_t>(frame - begin);
+				out.write(stamp, static_cast<::std::streamsize>(stampSize));
+				stampSize = 0;
+				if (site < sites.size() && !sites[site].empty())
+					out << sites[site] << '\n';
+				if (!FormatBinaryArguments(out, data, length))
+					return static_cast<::std::size_t>(frame - begin);
+				data += length;
+				break;
+			}
+			case TimeFrame:
+			{
+				::std::uint64_t time;
+				if (!read(&time, sizeof(time)))
+					return static_cast<::std::size_t>(frame - begin);
+				stampSize = formatter.format(time, stamp);
+				break;
+			}
+			default:
+				return static_cast<::std::size_t>(frame - begin);
+			}
+		}
+		return size;
+	}
+}
+
+#endif /* DEBUG_LIB_BINARY_RECORD_HPP__ */
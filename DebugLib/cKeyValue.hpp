@@ -0,0 +1,297 @@
+#pragma once
+#ifndef DEBUG_LIB_KEY_VALUE_HPP__
+#define DEBUG_LIB_KEY_VALUE_HPP__ "1.0.0@cKeyValue.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains encoder of structured key-value fields of DebugLib messages.
+*		Fields are written as one JSON object per line (JSON-lines) into a fixed buffer
+*		on the stack of calling thread, so encoding makes no allocations.
+*		Binary log stores the same fields as tagged values (See: cBinaryRecord.hpp).
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+/// DebugLib
+#include "cRecord.hpp"
+
+//	Maximal size of one line of key-value fields in bytes : fields that do not fit are discarded
+#ifndef DEBUG_LIB_KV_SIZE
+#	define DEBUG_LIB_KV_SIZE 256
+#endif
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Encoder of one JSON object with fields of one DEBUG_KV call.
+	 *	Keys and values are written in order of arguments. Integers, floating point values,
+	 *	booleans and strings keep their JSON types, pointers are written as hexadecimal strings (null pointers as null),
+	 *	values of other types are formatted with operator<< and written as strings.
+	 *	Field that does not fit into the buffer is discarded as a whole, the object is always closed.
+	 */
+	class KeyValueWriter
+	{
+	public:
+
+		KeyValueWriter() : size(1), overflow(false)
+		{
+			text[0] = '{';
+		}
+
+		/**
+		 *	@brief Adds one field to the object.
+		 *	@param key Name of the field.
+		 *	@param keyLength Count of characters in key.
+		 *	@param value Value of the field.
+		 */
+		template < typename T >
+		void add(const char* key, ::std::size_t keyLength, const T& value)
+		{
+			const ::std::size_t mark = begin(key, keyLength);
+			putValue(value);
+			end(mark);
+		}
+
+		/**
+		 *	@brief Adds one field which value is a string of given length.
+		 */
+		void addString(const char* key, ::std::size_t keyLength, const char* data, ::std::size_t length)
+		{
+			const ::std::size_t mark = begin(key, keyLength);
+			putString(data, length);
+			end(mark);
+		}
+
+		/**
+		 *	@brief Closes the object.
+		 *	@return Null-terminated text of the object.
+		 */
+		const char* finish()
+		{
+			text[size++] = '}';
+			text[size] = '\0';
+			return text;
+		}
+
+	private:
+
+		::std::size_t begin(const char* key, ::std::size_t keyLength)
+		{
+			const ::std::size_t mark = size;
+			if (size > 1)
+				put(',');
+			putString(key, keyLength);
+			put(':');
+			return mark;
+		}
+
+		void end(::std::size_t mark)
+		{
+			if (overflow)
+			{
+				size = mark;
+				overflow = false;
+			}
+		}
+
+		void put(char value)
+		{
+			if (size < DEBUG_LIB_KV_SIZE - 1)
+				text[size++] = value;
+			else
+				overflow = true;
+		}
+
+		void put(const char* data, ::std::size_t length)
+		{
+			if (length <= DEBUG_LIB_KV_SIZE - 1 - size)
+			{
+				::std::memcpy(text + size, data, length);
+				size += length;
+			}
+			else
+				overflow = true;
+		}
+
+		void putString(const char* data, ::std::size_t length)
+		{
+			static const char digits[] = "0123456789abcdef";
+			put('"');
+			for (const char* end = data + length; data != end && !overflow; ++data)
+			{
+				const unsigned char value = static_cast<unsigned char>(*data);
+				switch (value)
+				{
+				case '"': put("\\\"", 2); break;
+				case '\\': put("\\\\", 2); break;
+				case '\n': put("\\n", 2); break;
+				case '\r': put("\\r", 2); break;
+				case '\t': put("\\t", 2); break;
+				default:
+					if (value < 0x20)
+					{
+						const char escaped[] = { '\\', 'u', '0', '0', digits[value >> 4], digits[value & 0xF] };
+						put(escaped, sizeof(escaped));
+					}
+					else
+						put(static_cast<char>(value));
+				}
+			}
+			put('"');
+		}
+
+		void putUnsigned(unsigned long long value, bool negative)
+		{
+			char digits[24];
+			char* digit = digits + sizeof(digits);
+			do
+				*--digit = static_cast<char>('0' + value % 10);
+			while (value /= 10);
+			if (negative)
+				*--digit = '-';
+			put(digit, static_cast<::std::size_t>(digits + sizeof(digits) - digit));
+		}
+
+		void putSigned(long long value)
+		{
+			putUnsigned(value < 0 ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value), value < 0);
+		}
+
+		template < typename T >
+		void putFloat(T value, int precision)
+		{
+			// JSON has no representation of infinities and NaN
+			if (!::std::isfinite(value))
+				return put("null", 4);
+			char digits[32];
+			int length = ::std::snprintf(digits, sizeof(digits), "%.*g", precision - 2, static_cast<double>(value));
+			// Shorter form is used if it is read back to the same value
+			if (static_cast<T>(::std::strtod(digits, nullptr)) != value)
+				length = ::std::snprintf(digits, sizeof(digits), "%.*g", precision, static_cast<double>(value));
+			put(digits, static_cast<::std::size_t>(length));
+		}
+
+		void putValue(bool value) { value ? put("true", 4) : put("false", 5); }
+		void putValue(char value) { putString(&value, 1); }
+		void putValue(signed char value) { putValue(static_cast<char>(value)); }
+		void putValue(unsigned char value) { putValue(static_cast<char>(value)); }
+		void putValue(short value) { putSigned(value); }
+		void putValue(unsigned short value) { putUnsigned(value, false); }
+		void putValue(int value) { putSigned(value); }
+		void putValue(unsigned int value) { putUnsigned(value, false); }
+		void putValue(long value) { putSigned(value); }
+		void putValue(unsigned long value) { putUnsigned(value, false); }
+		void putValue(long long value) { putSigned(value); }
+		void putValue(unsigned long long value) { putUnsigned(value, false); }
+		void putValue(float value) { putFloat(value, 9); }
+		void putValue(double value) { putFloat(value, 17); }
+		void putValue(long double value) { putFloat(static_cast<double>(value), 17); }
+		void putValue(::std::nullptr_t) { put("null", 4); }
+		void putValue(const char* value) { value ? putString(value, ::std::strlen(value)) : put("null", 4); }
+		void putValue(char* value) { putValue(static_cast<const char*>(value)); }
+
+		void putValue(const void* value)
+		{
+			if (!value)
+				return put("null", 4);
+			char digits[24];
+			const int length = ::std::snprintf(digits, sizeof(digits), "0x%llx",
+				static_cast<unsigned long long>(reinterpret_cast<::std::uintptr_t>(value)));
+			putString(digits, static_cast<::std::size_t>(length));
+		}
+
+		template < typename T >
+		void putValue(T* value)
+		{
+			putValue(static_cast<const void*>(value));
+		}
+
+		template < ::std::size_t N >
+		void putValue(const char (&value)[N])
+		{
+			putValue(static_cast<const char*>(value));
+		}
+
+		template < typename Traits, typename Alloc >
+		void putValue(const ::std::basic_string<char, Traits, Alloc>& value)
+		{
+			putString(value.data(), value.size());
+		}
+
+		template < typename T >
+		void putValue(const T& value)
+		{
+			static thread_local RecordStream scratch;
+			scratch.open(static_cast<Level>(0)) << value;
+			const Record& formatted = scratch.close();
+			putString(formatted.data, formatted.size);
+		}
+
+		char text[DEBUG_LIB_KV_SIZE + 1];
+		::std::size_t size;
+		bool overflow;
+
+		KeyValueWriter(const KeyValueWriter&) = delete;
+		KeyValueWriter& operator=(const KeyValueWriter&) = delete;
+	};
+
+	inline void AddKeyValues(KeyValueWriter&) {}
+
+	template < typename T, typename... Fields >
+	void AddKeyValues(KeyValueWriter& writer, const char* key, const T& value, const Fields&... fields)
+	{
+		writer.add(key, key ? ::std::strlen(key) : 0, value);
+		AddKeyValues(writer, fields...);
+	}
+
+	/**
+	 *	@brief Writes fields as one JSON object to the output of current message.
+	 *	@param out Text output of current message (See: DEBUG_LIB_MESSAGE_OUT).
+	 *	@param fields Pairs of C-string key and value.
+	 *	@return Reference to out.
+	 */
+	template < typename Out, typename... Fields >
+	Out& WriteKeyValues(Out& out, const Fields&... fields)
+	{
+		static_assert(sizeof...(Fields) % 2 == 0, "DEBUG_KV expects pairs of key and value");
+		KeyValueWriter writer;
+		AddKeyValues(writer, fields...);
+		out << writer.finish();
+		return out;
+	}
+}
+
+#endif /* DEBUG_LIB_KEY_VALUE_HPP__ */
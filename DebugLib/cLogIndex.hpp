@@ -0,0 +1,172 @@
+#pragma once
+#ifndef DEBUG_LIB_LOG_INDEX_HPP__
+#define DEBUG_LIB_LOG_INDEX_HPP__ "1.0.0@cLogIndex.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains layout of the sidecar index of DebugLib text log and a reader for it.
+*		Index is written by DebugLib if DEBUG_LIB_LOG_INDEX is defined and read by the offline tools.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/**
+*	Index layout (all integers are stored in native byte order):
+*		Session frame : 'S' u32(version)
+*		File frame    : 'F' u32(file id) u32(length) char[length](source file name)
+*		Entry frame   : 'E' u64(offset in log) u32(length) u8(level) u32(file id)
+*	File identifiers are local to the session and are given in order from 0. Entries of user messages refer to DEBUG_LIB_INDEX_NO_FILE.
+*	File frame is written before the first entry that refers to it.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//	Version of index layout
+#define DEBUG_LIB_INDEX_VERSION 1
+//	File identifier of messages without source file (user messages)
+#define DEBUG_LIB_INDEX_NO_FILE 0xFFFFFFFFu
+
+namespace DebugLib
+{
+	/**
+	 *	Defines the frame kinds of log index.
+	 */
+	enum IndexFrame : char
+	{
+		IndexSessionFrame = 'S',	//!< Start of the output of one process run
+		IndexFileFrame = 'F',		//!< Definition of source file name
+		IndexEntryFrame = 'E'		//!< Position of one message in log
+	};
+
+	/**
+	 *	@brief Position and properties of one message in log.
+	 */
+	struct IndexEntry
+	{
+		::std::uint64_t offset;	//!< Offset of the first byte of message in log
+		::std::uint32_t length;	//!< Count of bytes in message
+		::std::uint8_t level;	//!< Level of message (one of DebugLib::Level members)
+		::std::uint32_t file;	//!< Index of source file name in the file list or DEBUG_LIB_INDEX_NO_FILE
+	};
+
+	/**
+	 *	@brief Extracts source file name from the first line of message.
+	 *	@param header First line of message in form "LEVEL::file:line".
+	 *	@param length Receives the length of file name.
+	 *	@return Pointer to the first character of file name or nullptr if header has no file name.
+	 */
+	inline const char* GetHeaderFile(const char* header, ::std::size_t& length)
+	{
+		const char* begin = header ? ::std::strstr(header, "::") : nullptr;
+		if (!begin)
+			return nullptr;
+		begin += 2;
+		const char* end = ::std::strrchr(begin, ':');
+		if (!end)
+			return nullptr;
+		length = static_cast<::std::size_t>(end - begin);
+		return begin;
+	}
+
+	/**
+	 *	@brief Reads all sessions of log index.
+	 *	Equal file names of different sessions are merged into one element of the file list.
+	 *	@param data Content of index file.
+	 *	@param size Count of bytes in data.
+	 *	@param entries Receives entries in order of appearance in log.
+	 *	@param files Receives list of source file names.
+	 *	@return true if index is well-formed, false otherwise (entries read before the error are kept).
+	 */
+	inline bool ReadIndex(const char* data, ::std::size_t size, ::std::vector<IndexEntry>& entries, ::std::vector<::std::string>& files)
+	{
+		const char* const end = data + size;
+		::std::vector<::std::uint32_t> sessionFiles;
+		const auto read = [&data, end](void* value, ::std::size_t count)
+		{
+			if (static_cast<::std::size_t>(end - data) < count)
+				return false;
+			::std::memcpy(value, data, count);
+			data += count;
+			return true;
+		};
+		while (data < end)
+		{
+			const char kind = *data++;
+			switch (kind)
+			{
+			case IndexSessionFrame:
+			{
+				::std::uint32_t version;
+				if (!read(&version, sizeof(version)) || version != DEBUG_LIB_INDEX_VERSION)
+					return false;
+				sessionFiles.clear();
+				break;
+			}
+			case IndexFileFrame:
+			{
+				// Files are defined in order of their identifiers
+				::std::uint32_t id, length;
+				if (!read(&id, sizeof(id)) || !read(&length, sizeof(length)) || id > sessionFiles.size() ||
+					static_cast<::std::size_t>(end - data) < length)
+					return false;
+				const ::std::string name(data, length);
+				data += length;
+				::std::size_t global = 0;
+				while (global < files.size() && files[global] != name)
+					++global;
+				if (global == files.size())
+					files.push_back(name);
+				if (id == sessionFiles.size())
+					sessionFiles.push_back(DEBUG_LIB_INDEX_NO_FILE);
+				sessionFiles[id] = static_cast<::std::uint32_t>(global);
+				break;
+			}
+			case IndexEntryFrame:
+			{
+				IndexEntry entry;
+				::std::uint32_t file;
+				if (!read(&entry.offset, sizeof(entry.offset)) || !read(&entry.length, sizeof(entry.length)) ||
+					!read(&entry.level, sizeof(entry.level)) || !read(&file, sizeof(file)))
+					return false;
+				entry.file = file < sessionFiles.size() ? sessionFiles[file] : DEBUG_LIB_INDEX_NO_FILE;
+				entries.push_back(entry);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+#endif /* DEBUG_LIB_LOG_INDEX_HPP__ */
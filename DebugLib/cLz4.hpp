@@ -0,0 +1,222 @@
+#pragma once
+#ifndef DEBUG_LIB_LZ4_HPP__
+#define DEBUG_LIB_LZ4_HPP__ "1.0.0@cLz4.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains minimal LZ4 frame compressor used by DebugLib to pack rotated log segments.
+*		Output follows LZ4 frame format with independent 64 KiB blocks and may be unpacked by any
+*		LZ4 implementation (for example: lz4 -d log.dat.segment.lz4).
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+//	Size of uncompressed block of LZ4 frame : 64 KiB is the smallest size defined by the format
+#define DEBUG_LIB_LZ4_BLOCK_SIZE (64 * 1024)
+//	Count of bits of match search hash table index
+#define DEBUG_LIB_LZ4_HASH_BITS 12
+
+namespace DebugLib
+{
+	namespace Lz4
+	{
+		inline ::std::uint32_t read32(const unsigned char* data)
+		{
+			::std::uint32_t value;
+			::std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		inline void write32(unsigned char* data, ::std::uint32_t value)
+		{
+			data[0] = static_cast<unsigned char>(value);
+			data[1] = static_cast<unsigned char>(value >> 8);
+			data[2] = static_cast<unsigned char>(value >> 16);
+			data[3] = static_cast<unsigned char>(value >> 24);
+		}
+
+		inline ::std::uint32_t rotl(::std::uint32_t value, int bits)
+		{
+			return (value << bits) | (value >> (32 - bits));
+		}
+
+		/**
+		 *	@brief xxHash32 with zero seed for inputs shorter than 16 bytes.
+		 *	Used only for checksum of frame descriptor.
+		 */
+		inline ::std::uint32_t ShortHash(const unsigned char* data, ::std::size_t size)
+		{
+			const ::std::uint32_t p1 = 2654435761u, p2 = 2246822519u, p3 = 3266489917u, p4 = 668265263u, p5 = 374761393u;
+			::std::uint32_t hash = p5 + static_cast<::std::uint32_t>(size);
+			for (; size >= 4; data += 4, size -= 4)
+				hash = rotl(hash + (static_cast<::std::uint32_t>(data[0]) | static_cast<::std::uint32_t>(data[1]) << 8 |
+					static_cast<::std::uint32_t>(data[2]) << 16 | static_cast<::std::uint32_t>(data[3]) << 24) * p3, 17) * p4;
+			for (; size; ++data, --size)
+				hash = rotl(hash + *data * p5, 11) * p1;
+			hash ^= hash >> 15;
+			hash *= p2;
+			hash ^= hash >> 13;
+			hash *= p3;
+			hash ^= hash >> 16;
+			return hash;
+		}
+
+		/**
+		 *	@brief Maximal size of compressed block for the input of given size.
+		 */
+		inline ::std::size_t BlockBound(::std::size_t size)
+		{
+			return size + size / 255 + 16;
+		}
+
+		inline unsigned char* writeLength(unsigned char* out, ::std::size_t length)
+		{
+			for (; length >= 255; length -= 255)
+				*out++ = 255;
+			*out++ = static_cast<unsigned char>(length);
+			return out;
+		}
+
+		/**
+		 *	@brief Compresses one independent block with greedy single-probe match search.
+		 *	@param source Input bytes.
+		 *	@param size Count of input bytes, must not exceed 64 KiB.
+		 *	@param destination Output buffer of at least BlockBound(size) bytes.
+		 *	@return Count of bytes written to destination.
+		 */
+		inline ::std::size_t CompressBlock(const char* source, ::std::size_t size, char* destination)
+		{
+			// Format limits : last match starts 12 bytes before the end, last 5 bytes are literals
+			const ::std::size_t minMatch = 4, matchStartLimit = 12, lastLiterals = 5;
+			const unsigned char* const in = reinterpret_cast<const unsigned char*>(source);
+			unsigned char* out = reinterpret_cast<unsigned char*>(destination);
+			::std::size_t anchor = 0;
+			if (size > matchStartLimit)
+			{
+				// Positions are stored plus one : zero marks an empty entry
+				::std::uint32_t table[1 << DEBUG_LIB_LZ4_HASH_BITS] = {};
+				const ::std::size_t searchEnd = size - matchStartLimit;
+				const ::std::size_t matchEnd = size - lastLiterals;
+				::std::size_t pos = 0;
+				while (pos < searchEnd)
+				{
+					const ::std::uint32_t sequence = read32(in + pos);
+					const ::std::uint32_t hash = (sequence * 2654435761u) >> (32 - DEBUG_LIB_LZ4_HASH_BITS);
+					const ::std::size_t candidate = table[hash];
+					table[hash] = static_cast<::std::uint32_t>(pos + 1);
+					if (!candidate || pos - (candidate - 1) > 0xFFFF || read32(in + candidate - 1) != sequence)
+					{
+						++pos;
+						continue;
+					}
+					::std::size_t ref = candidate - 1;
+					::std::size_t length = minMatch;
+					while (pos + length < matchEnd && in[ref + length] == in[pos + length])
+						++length;
+					while (pos > anchor && ref > 0 && in[pos - 1] == in[ref - 1])
+					{
+						--pos;
+						--ref;
+						++length;
+					}
+					const ::std::size_t literals = pos - anchor;
+					const ::std::size_t extra = length - minMatch;
+					unsigned char* token = out++;
+					*token = static_cast<unsigned char>((literals < 15 ? literals : 15) << 4 | (extra < 15 ? extra : 15));
+					if (literals >= 15)
+						out = writeLength(out, literals - 15);
+					::std::memcpy(out, in + anchor, literals);
+					out += literals;
+					const ::std::size_t offset = pos - ref;
+					*out++ = static_cast<unsigned char>(offset);
+					*out++ = static_cast<unsigned char>(offset >> 8);
+					if (extra >= 15)
+						out = writeLength(out, extra - 15);
+					pos += length;
+					anchor = pos;
+				}
+			}
+			const ::std::size_t literals = size - anchor;
+			*out++ = static_cast<unsigned char>((literals < 15 ? literals : 15) << 4);
+			if (literals >= 15)
+				out = writeLength(out, literals - 15);
+			::std::memcpy(out, in + anchor, literals);
+			out += literals;
+			return static_cast<::std::size_t>(out - reinterpret_cast<unsigned char*>(destination));
+		}
+
+		/**
+		 *	@brief Compresses the whole input stream to LZ4 frame.
+		 *	Blocks that do not shrink are stored uncompressed.
+		 *	@return true if all data was written, false otherwise.
+		 */
+		inline bool CompressStream(::std::istream& input, ::std::ostream& output)
+		{
+			unsigned char header[7] = { 0x04, 0x22, 0x4D, 0x18, 0x60, 0x40, 0 };
+			// Version 01, independent blocks, no checksums : 64 KiB blocks
+			header[6] = static_cast<unsigned char>(ShortHash(header + 4, 2) >> 8);
+			output.write(reinterpret_cast<const char*>(header), sizeof(header));
+			::std::vector<char> block(DEBUG_LIB_LZ4_BLOCK_SIZE);
+			::std::vector<char> packed(BlockBound(DEBUG_LIB_LZ4_BLOCK_SIZE));
+			unsigned char size[4];
+			while (input)
+			{
+				input.read(block.data(), DEBUG_LIB_LZ4_BLOCK_SIZE);
+				const ::std::size_t count = static_cast<::std::size_t>(input.gcount());
+				if (!count)
+					break;
+				const ::std::size_t length = CompressBlock(block.data(), count, packed.data());
+				if (length < count)
+				{
+					write32(size, static_cast<::std::uint32_t>(length));
+					output.write(reinterpret_cast<const char*>(size), sizeof(size));
+					output.write(packed.data(), static_cast<::std::streamsize>(length));
+				}
+				else
+				{
+					write32(size, static_cast<::std::uint32_t>(count) | 0x80000000u);
+					output.write(reinterpret_cast<const char*>(size), sizeof(size));
+					output.write(block.data(), static_cast<::std::streamsize>(count));
+				}
+			}
+			write32(size, 0);
+			output.write(reinterpret_cast<const char*>(size), sizeof(size));
+			return !input.bad() && static_cast<bool>(output.flush());
+		}
+	}
+}
+
+#endif /* DEBUG_LIB_LZ4_HPP__ */
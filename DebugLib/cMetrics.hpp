@@ -0,0 +1,183 @@
+#pragma once
+#ifndef DEBUG_LIB_METRICS_HPP__
+#define DEBUG_LIB_METRICS_HPP__ "1.0.0@cMetrics.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains named counters, gauges and histograms of DebugLib (See: DEBUG_LIB_METRICS).
+*		Counters and histograms are updated in shards of calling thread, so an update is a plain
+*		load and store of a relaxed atomic. Shards are summed by the background reporter that
+*		writes snapshots as DebugLib messages.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#if defined(_MSC_VER) && defined(_M_X64)
+#	include <intrin.h>
+#endif
+
+//	Size of cache line of target platform in bytes
+#ifndef DEBUG_LIB_CACHE_LINE_SIZE
+#	define DEBUG_LIB_CACHE_LINE_SIZE 64
+#endif
+
+//	Count of shard slots of one histogram : 65 buckets and the sum of values
+#define DEBUG_LIB_HISTOGRAM_SLOTS 66
+
+namespace DebugLib
+{
+	/**
+	 *	Defines the possible kinds of metrics.
+	 */
+	enum MetricKind : int
+	{
+		Counter,	//!< Sum of all added values
+		Gauge,		//!< Last set value
+		Histogram	//!< Count of values in buckets of powers of two and their sum
+	};
+
+	/**
+	 *	@brief Counters and histograms of one thread.
+	 *	Only the owner thread writes slots, so updates need no read-modify-write operations.
+	 *	Slots past DEBUG_LIB_METRICS_SLOTS take updates of metrics that did not fit and are never reported.
+	 */
+	struct alignas(DEBUG_LIB_CACHE_LINE_SIZE) MetricShard
+	{
+		MetricShard() : used(true)
+		{
+			for (auto& slot : slots)
+				slot.store(0, ::std::memory_order_relaxed);
+		}
+
+		void add(::std::uint32_t slot, ::std::uint64_t value)
+		{
+			slots[slot].store(slots[slot].load(::std::memory_order_relaxed) + value, ::std::memory_order_relaxed);
+		}
+
+		::std::atomic<::std::uint64_t> slots[DEBUG_LIB_METRICS_SLOTS + DEBUG_LIB_HISTOGRAM_SLOTS];
+		::std::atomic<bool> used;	//!< Shard belongs to a running thread
+	};
+
+	/**
+	 *	@brief Values of gauges : shared by all threads, the last one past DEBUG_LIB_METRICS_GAUGES is never reported.
+	 *	Defined in DebugLib.cpp.
+	 */
+	extern ::std::atomic<::std::int64_t> DEBUG_LIB_METRIC_GAUGES_VAR_NAME[DEBUG_LIB_METRICS_GAUGES + 1];
+
+	/**
+	 *	@brief Registers metric on the first use of its call site.
+	 *	Call sites with the same name and kind share one metric. Starts the reporter on the first call.
+	 *	@param name Null-terminated name of metric, must stay valid until program exit.
+	 *	@return Identifier of metric used by update functions.
+	 */
+	::std::uint32_t RegisterMetric(const char* name, MetricKind kind);
+
+	/**
+	 *	@brief Gives calling thread a shard that is not used by any running thread.
+	 */
+	MetricShard* AcquireMetricShard();
+
+	/**
+	 *	@brief Provides shard of calling thread.
+	 */
+	inline MetricShard& GetMetricShard()
+	{
+		static thread_local MetricShard* shard = nullptr;
+		if (!shard)
+			shard = AcquireMetricShard();
+		return *shard;
+	}
+
+	/**
+	 *	@brief Histogram bucket of value : 0 for zero, k for values from 2^(k-1) to 2^k - 1.
+	 */
+	inline unsigned HistogramBucket(::std::uint64_t value)
+	{
+#if defined(__GNUC__)
+		return value ? 64 - static_cast<unsigned>(__builtin_clzll(value)) : 0;
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		return _BitScanReverse64(&index, value) ? static_cast<unsigned>(index) + 1 : 0;
+#else
+		unsigned bucket = 0;
+		for (; value; value >>= 1)
+			++bucket;
+		return bucket;
+#endif
+	}
+
+	/**
+	 *	@brief Upper bound of values of histogram bucket.
+	 */
+	inline ::std::uint64_t HistogramBound(unsigned bucket)
+	{
+		return bucket >= 64 ? ~static_cast<::std::uint64_t>(0) : (static_cast<::std::uint64_t>(1) << bucket) - 1;
+	}
+
+	/**
+	 *	@brief Upper bound of the bucket that holds given percentile of histogram values.
+	 *	@param buckets Counts of values in DEBUG_LIB_HISTOGRAM_SLOTS - 1 buckets.
+	 *	@param count Count of all values.
+	 *	@param percent Percentile from 1 to 100 : 100 gives the bound of the highest bucket that is not empty.
+	 *	@return 0 if histogram has no values.
+	 */
+	inline ::std::uint64_t HistogramPercentile(const ::std::uint64_t* buckets, ::std::uint64_t count, unsigned percent)
+	{
+		::std::uint64_t seen = 0;
+		for (unsigned bucket = 0; bucket < DEBUG_LIB_HISTOGRAM_SLOTS - 1; ++bucket)
+		{
+			seen += buckets[bucket];
+			if (seen * 100 >= count * percent)
+				return HistogramBound(bucket);
+		}
+		return 0;
+	}
+
+	inline void AddCounter(::std::uint32_t id, ::std::uint64_t value)
+	{
+		GetMetricShard().add(id, value);
+	}
+
+	inline void SetGauge(::std::uint32_t id, ::std::int64_t value)
+	{
+		DEBUG_LIB_METRIC_GAUGES_VAR_NAME[id].store(value, ::std::memory_order_relaxed);
+	}
+
+	inline void RecordHistogram(::std::uint32_t id, ::std::uint64_t value)
+	{
+		MetricShard& shard = GetMetricShard();
+		shard.add(id + HistogramBucket(value), 1);
+		shard.add(id + DEBUG_LIB_HISTOGRAM_SLOTS - 1, value);
+	}
+}
+
+#endif /* DEBUG_LIB_METRICS_HPP__ */
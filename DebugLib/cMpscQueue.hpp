@@ -0,0 +1,200 @@
+#pragma once
+#ifndef DEBUG_LIB_MPSC_QUEUE_HPP__
+#define DEBUG_LIB_MPSC_QUEUE_HPP__ "1.0.0@cMpscQueue.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains implementation of bounded lock-free multi-producer queue used as DebugLib transport.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <atomic>
+
+//	Size of cache line of target platform in bytes
+#ifndef DEBUG_LIB_CACHE_LINE_SIZE
+#	define DEBUG_LIB_CACHE_LINE_SIZE 64
+#endif
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Bounded lock-free queue with sequence numbered slots.
+	 *	Any count of threads may push. Popping is also safe from several threads, it is used
+	 *	by producers to discard the oldest element. Every slot and both positions are placed on
+	 *	separate cache lines so producers and consumer do not invalidate each other.
+	 *	@tparam T Type of element, must be default constructible.
+	 *	@tparam Capacity Count of slots, must be a power of two.
+	 */
+	template < typename T, ::std::size_t Capacity >
+	class MpscQueue
+	{
+		static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MpscQueue capacity must be a power of two");
+
+		struct alignas(DEBUG_LIB_CACHE_LINE_SIZE) Slot
+		{
+			::std::atomic<::std::size_t> sequence;
+			T value;
+		};
+
+	public:
+
+		MpscQueue() : enqueuePos(0), dequeuePos(0)
+		{
+			for (::std::size_t i = 0; i < Capacity; ++i)
+				slots[i].sequence.store(i, ::std::memory_order_relaxed);
+		}
+
+		/**
+		 *	@brief Try to place a new element to the queue.
+		 *	@param fill Callable that receives reference to the reserved element and fills it.
+		 *	@return true if element was placed, false if queue is full.
+		 */
+		template < typename Fill >
+		bool try_push(Fill&& fill)
+		{
+			Slot* slot;
+			::std::size_t pos = enqueuePos.load(::std::memory_order_relaxed);
+			for (;;)
+			{
+				slot = &slots[pos & (Capacity - 1)];
+				const ::std::size_t seq = slot->sequence.load(::std::memory_order_acquire);
+				const ::std::ptrdiff_t diff = static_cast<::std::ptrdiff_t>(seq) - static_cast<::std::ptrdiff_t>(pos);
+				if (diff == 0)
+				{
+					if (enqueuePos.compare_exchange_weak(pos, pos + 1, ::std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = enqueuePos.load(::std::memory_order_relaxed);
+			}
+			fill(slot->value);
+			slot->sequence.store(pos + 1, ::std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 *	@brief Try to take the oldest element from the queue.
+		 *	@param consume Callable that receives reference to the element, slot is reused after it returns.
+		 *	@return true if element was taken, false if queue is empty.
+		 */
+		template < typename Consume >
+		bool try_pop(Consume&& consume)
+		{
+			::std::size_t ticket;
+			T* const value = try_acquire(ticket);
+			if (!value)
+				return false;
+			consume(*value);
+			release(ticket);
+			return true;
+		}
+
+		/**
+		 *	@brief Try to take the oldest element from the queue and keep its slot.
+		 *	Slot is not reused until release is called, producers see it as a full slot meanwhile.
+		 *	Taken elements may be released in any order.
+		 *	@param ticket Receives position of the element to be passed to release.
+		 *	@return Pointer to the element or nullptr if queue is empty.
+		 */
+		T* try_acquire(::std::size_t& ticket)
+		{
+			Slot* slot;
+			::std::size_t pos = dequeuePos.load(::std::memory_order_relaxed);
+			for (;;)
+			{
+				slot = &slots[pos & (Capacity - 1)];
+				const ::std::size_t seq = slot->sequence.load(::std::memory_order_acquire);
+				const ::std::ptrdiff_t diff = static_cast<::std::ptrdiff_t>(seq) - static_cast<::std::ptrdiff_t>(pos + 1);
+				if (diff == 0)
+				{
+					if (dequeuePos.compare_exchange_weak(pos, pos + 1, ::std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return nullptr;
+				else
+					pos = dequeuePos.load(::std::memory_order_relaxed);
+			}
+			ticket = pos;
+			return &slot->value;
+		}
+
+		/**
+		 *	@brief Makes slot of element taken by try_acquire free for producers.
+		 *	@param ticket Position of the element received from try_acquire.
+		 */
+		void release(::std::size_t ticket)
+		{
+			slots[ticket & (Capacity - 1)].sequence.store(ticket + Capacity, ::std::memory_order_release);
+		}
+
+		/**
+		 *	@brief Checks whether the queue has no published elements.
+		 *	Result may be outdated as soon as it is returned.
+		 */
+		bool empty() const
+		{
+			const ::std::size_t pos = dequeuePos.load(::std::memory_order_relaxed);
+			return slots[pos & (Capacity - 1)].sequence.load(::std::memory_order_acquire) != pos + 1;
+		}
+
+		/**
+		 *	@brief Visits published elements from the oldest one without taking them.
+		 *	Makes no waits and no changes, so it may be used from a signal handler. Elements taken or
+		 *	reused concurrently may still be visited, visiting stops at the first unpublished slot.
+		 *	@param visit Callable that receives constant reference to the element.
+		 */
+		template < typename Visit >
+		void peek(Visit&& visit) const
+		{
+			const ::std::size_t end = enqueuePos.load(::std::memory_order_acquire);
+			for (::std::size_t pos = dequeuePos.load(::std::memory_order_acquire); pos != end; ++pos)
+			{
+				const Slot& slot = slots[pos & (Capacity - 1)];
+				if (slot.sequence.load(::std::memory_order_acquire) != pos + 1)
+					break;
+				visit(slot.value);
+			}
+		}
+
+	private:
+		alignas(DEBUG_LIB_CACHE_LINE_SIZE) ::std::atomic<::std::size_t> enqueuePos;
+		alignas(DEBUG_LIB_CACHE_LINE_SIZE) ::std::atomic<::std::size_t> dequeuePos;
+		Slot slots[Capacity];
+
+		MpscQueue(const MpscQueue&) = delete;
+		MpscQueue& operator=(const MpscQueue&) = delete;
+	};
+}
+
+#endif /* DEBUG_LIB_MPSC_QUEUE_HPP__ */
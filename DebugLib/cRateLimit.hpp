@@ -0,0 +1,183 @@
+#pragma once
+#ifndef DEBUG_LIB_RATE_LIMIT_HPP__
+#define DEBUG_LIB_RATE_LIMIT_HPP__ "1.0.0@cRateLimit.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains call site state of rate limited and sampled messages of DebugLib.
+*		Every call site owns one static SuppressionSite and one thread-local SuppressionState,
+*		so the check of a passed message is an increment of thread-local counter.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Shared state of one rate limited or sampled call site.
+	 *	Constant initialized, so static instances in message macros need no initialization guard.
+	 *	Site is added to the list of reported sites when it suppresses a message for the first time.
+	 */
+	struct SuppressionSite
+	{
+		constexpr explicit SuppressionSite(const char* header) :
+			header(header),
+			suppressed(0),
+			registered(false),
+			next(nullptr)
+		{}
+
+		const char* const header;					//!< First line of messages of the call site
+		::std::atomic<::std::uint64_t> suppressed;	//!< Count of suppressed messages not yet reported
+		::std::atomic<bool> registered;				//!< Site is in the list of reported sites
+		SuppressionSite* next;						//!< Next site in the list of reported sites
+
+		SuppressionSite(const SuppressionSite&) = delete;
+		SuppressionSite& operator=(const SuppressionSite&) = delete;
+	};
+
+	/**
+	 *	@brief State of one rate limited or sampled call site owned by one thread.
+	 *	Must be zero initialized (thread_local variable of static storage duration).
+	 */
+	struct SuppressionState
+	{
+		::std::uint32_t count;		//!< Messages passed in current window or position in sampling cycle
+		::std::uint32_t suppressed;	//!< Suppressed messages not yet added to the site
+		::std::int64_t windowEnd;	//!< End of current rate limiting window in nanoseconds of steady clock
+	};
+
+	/**
+	 *	@brief Adds call site to the list of reported sites.
+	 */
+	void RegisterSuppressionSite(SuppressionSite& site);
+
+	/**
+	 *	@brief Writes summary message of suppressed counts of all sites if DEBUG_LIB_SUPPRESSION_SUMMARY_PERIOD
+	 *	passed since the previous summary. Only one thread writes each summary.
+	 *	Must not be called inside a message.
+	 *	@param now Current time in nanoseconds of steady clock.
+	 */
+	void ReportSuppressed(::std::int64_t now);
+
+	inline ::std::int64_t SuppressionClock()
+	{
+		return static_cast<::std::int64_t>(::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+			::std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	inline void AddSuppressed(SuppressionSite& site, ::std::uint64_t count)
+	{
+		site.suppressed.fetch_add(count, ::std::memory_order_relaxed);
+		if (!site.registered.load(::std::memory_order_relaxed))
+			RegisterSuppressionSite(site);
+	}
+
+	/**
+	 *	@brief Adds suppressed messages counted by calling thread to the site and reports them.
+	 *	@param now Current time in nanoseconds of steady clock.
+	 */
+	inline void FlushSuppressed(SuppressionSite& site, SuppressionState& state, ::std::int64_t now)
+	{
+		AddSuppressed(site, state.suppressed);
+		state.suppressed = 0;
+		ReportSuppressed(now);
+	}
+
+	/**
+	 *	@brief Passes the first message of every period messages of calling thread.
+	 *	Sampled out messages cost one thread-local increment. They are added to the site
+	 *	and reported when the next message of the cycle passes.
+	 *	@param period Count of messages in sampling cycle, 0 and 1 pass every message.
+	 *	@return true if message must be written, false otherwise.
+	 */
+	inline bool SampleMessage(SuppressionSite& site, SuppressionState& state, ::std::uint32_t period)
+	{
+		if (state.count)
+		{
+			if (++state.count >= period)
+				state.count = 0;
+			++state.suppressed;
+			return false;
+		}
+		if (period > 1)
+			state.count = 1;
+		if (state.suppressed)
+			FlushSuppressed(site, state, SuppressionClock());
+		return true;
+	}
+
+	/**
+	 *	@brief Passes at most limit messages of calling thread in every window of given length.
+	 *	Window starts with the first message passed after the previous window ended. Passed messages
+	 *	read the clock. Suppressed messages cost two thread-local increments and read the clock only
+	 *	on checkpoints: suppressed message 1, 2, 4 ... of the window and then every
+	 *	DEBUG_LIB_SUPPRESSION_CHECK_PERIOD-th. On a checkpoint the message passes and starts a new window
+	 *	if the window ended, otherwise suppressed messages counted so far are added to the site.
+	 *	@param limit Count of messages passed in one window.
+	 *	@param window Length of window in milliseconds.
+	 *	@return true if message must be written, false otherwise.
+	 */
+	inline bool LimitMessage(SuppressionSite& site, SuppressionState& state, ::std::uint32_t limit, ::std::int64_t window)
+	{
+		::std::int64_t now;
+		if (state.count >= limit)
+		{
+			const ::std::uint32_t over = ++state.count - limit;
+			++state.suppressed;
+			if ((over & (over - 1)) && over % DEBUG_LIB_SUPPRESSION_CHECK_PERIOD)
+				return false;
+			now = SuppressionClock();
+			if (!limit || now < state.windowEnd)
+			{
+				FlushSuppressed(site, state, now);
+				return false;
+			}
+			--state.suppressed;
+			state.count = 0;
+		}
+		else
+			now = SuppressionClock();
+		if (!state.count || now >= state.windowEnd)
+		{
+			state.count = 0;
+			state.windowEnd = now + window * 1000000;
+			if (state.suppressed)
+				FlushSuppressed(site, state, now);
+		}
+		++state.count;
+		return true;
+	}
+}
+
+#endif /* DEBUG_LIB_RATE_LIMIT_HPP__ */
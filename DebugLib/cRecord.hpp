@@ -0,0 +1,238 @@
+#pragma once
+#ifndef DEBUG_LIB_RECORD_HPP__
+#define DEBUG_LIB_RECORD_HPP__ "1.0.0@cRecord.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains implementation of message record used by buffered output modes of DebugLib.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <streambuf>
+#include <ostream>
+/// DebugLib
+#ifdef DEBUG_LIB_TIMESTAMP
+#	include "cTimestamp.hpp"
+#endif
+
+//	Maximal size of one message in bytes : longer messages are truncated
+#ifndef DEBUG_LIB_RECORD_SIZE
+#	define DEBUG_LIB_RECORD_SIZE 512
+#endif
+
+//	Attribute of functions called only by written messages : calls to them mark the path as cold
+#ifndef DEBUG_LIB_COLD_FUNCTION
+#	if defined(__GNUC__)
+#		define DEBUG_LIB_COLD_FUNCTION __attribute__((cold, noinline))
+#	else
+#		define DEBUG_LIB_COLD_FUNCTION
+#	endif
+#endif
+
+namespace DebugLib
+{
+	enum Level : int;
+
+	/**
+	 *	@brief Fixed-size storage for one message.
+	 *	One extra byte is reserved so the stored text is always null-terminated.
+	 */
+	struct Record
+	{
+		::std::size_t size;						//!< Count of used bytes in data
+		int level;								//!< Level of message (one of DebugLib::Level members)
+		::std::uint32_t site;					//!< Identifier of message call site (0 if not registered)
+		const char* header;						//!< Static first line of message (empty for user messages)
+#ifdef DEBUG_LIB_TIMESTAMP
+		::std::uint64_t ticks;					//!< Timestamp counter value at the start of message
+#endif
+		char data[DEBUG_LIB_RECORD_SIZE + 1];	//!< Message content
+	};
+
+	/**
+	 *	@brief Stream buffer that formats output directly into a Record.
+	 *	Output that does not fit into the record is discarded.
+	 */
+	class RecordBuffer : public ::std::streambuf
+	{
+	public:
+
+		RecordBuffer() : record() {}
+
+		/**
+		 *	@brief Prepares the record to capture a new message.
+		 *	@param level Level of the new message.
+		 *	@param header Static first line of the new message.
+		 */
+		void reset(Level level, const char* header)
+		{
+			record.level = static_cast<int>(level);
+			record.site = 0;
+			record.header = header;
+#ifdef DEBUG_LIB_TIMESTAMP
+			record.ticks = ReadTimestampCounter();
+#endif
+			setp(record.data, record.data + DEBUG_LIB_RECORD_SIZE);
+		}
+
+		/**
+		 *	@brief Finalizes the captured message.
+		 *	@return Reference to the record with null-terminated content.
+		 */
+		Record& finish()
+		{
+			record.size = static_cast<::std::size_t>(pptr() - pbase());
+			record.data[record.size] = '\0';
+			return record;
+		}
+
+	protected:
+
+		int_type overflow(int_type) override
+		{
+			return traits_type::eof();
+		}
+
+	private:
+		Record record;
+
+		RecordBuffer(const RecordBuffer&) = delete;
+		RecordBuffer& operator=(const RecordBuffer&) = delete;
+	};
+
+	/**
+	 *	@brief Output stream that captures one message at a time into a Record.
+	 *	Stream state and format are reset each time new message is opened.
+	 */
+	class RecordStream : public ::std::ostream
+	{
+	public:
+
+		RecordStream() : ::std::ostream(nullptr)
+		{
+			rdbuf(&buffer);
+		}
+
+		/**
+		 *	@brief Starts capturing of a new message.
+		 *	@param level Level of the new message.
+		 *	@param header Static first line of the new message.
+		 *	@return Reference to this stream.
+		 */
+		RecordStream& open(Level level, const char* header = "")
+		{
+			// Format state set by the previous message is not carried over
+			clear();
+			flags(::std::ios_base::dec | ::std::ios_base::skipws);
+			precision(6);
+			width(0);
+			fill(' ');
+			buffer.reset(level, header);
+			return *this;
+		}
+
+		/**
+		 *	@brief Ends capturing of current message.
+		 *	@return Reference to the captured record.
+		 */
+		Record& close()
+		{
+			return buffer.finish();
+		}
+
+	private:
+		RecordBuffer buffer;
+	};
+
+	/**
+	 *	@brief Starts a new message in the record stream of calling thread.
+	 *	Every thread owns exactly one record stream so no allocations are made per message.
+	 *	@param level Level of the new message.
+	 *	@param header Static first line of the new message, empty for user messages.
+	 *	@return Reference to the record stream of calling thread.
+	 */
+	inline RecordStream& OpenRecord(Level level, const char* header)
+	{
+		static thread_local RecordStream stream;
+		return stream.open(level, header);
+	}
+
+	/**
+	 *	@brief Ends the message started by OpenRecord and passes it to the output.
+	 *	@param stream Stream returned by OpenRecord.
+	 */
+	DEBUG_LIB_COLD_FUNCTION void CommitRecord(RecordStream& stream);
+
+	/**
+	 *	@brief Sends values separated by comma to output of current message one by one.
+	 *	Every value is passed to operator<< of the output itself, so its manipulators and overloads apply.
+	 *	Manipulators that are function templates (std::endl) are accepted by a separate overload.
+	 */
+	template < typename Out >
+	class ValueWriter
+	{
+	public:
+
+		explicit ValueWriter(Out& out_) : out(out_) {}
+
+		template < typename T >
+		ValueWriter& operator,(const T& value)
+		{
+			out << value;
+			return *this;
+		}
+
+		ValueWriter& operator,(::std::ostream& (*manipulator)(::std::ostream&))
+		{
+			out << manipulator;
+			return *this;
+		}
+
+	private:
+		Out& out;
+	};
+
+	/**
+	 *	@brief Starts output of any count of values to output of current message.
+	 *	Used as (WriteValues(out), value1, value2, ...) so no argument needs its type deduced in one call.
+	 *	@param out Output of current message (See: DEBUG_LIB_MESSAGE_OUT).
+	 *	@return Writer that sends every following value to out.
+	 */
+	template < typename Out >
+	ValueWriter<Out> WriteValues(Out& out)
+	{
+		return ValueWriter<Out>(out);
+	}
+}
+
+#endif /* DEBUG_LIB_RECORD_HPP__ */
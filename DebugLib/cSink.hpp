@@ -0,0 +1,163 @@
+#pragma once
+#ifndef DEBUG_LIB_SINK_HPP__
+#define DEBUG_LIB_SINK_HPP__ "1.0.0@cSink.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains interface of DebugLib output sinks and functions of runtime sink registry.
+*		Every finished message is routed by its level to all registered sinks (See: DEBUG_LIB_SINKS).
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <ostream>
+/// DebugLib
+#include "cRecord.hpp"
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Destination of finished messages.
+	 *	Sinks are called by one thread at a time: by the background writer if DEBUG_LIB_ASYNC is defined,
+	 *	by the thread that commits the message under the main mutex otherwise.
+	 *	Sink must not start DebugLib messages itself.
+	 */
+	class Sink
+	{
+	public:
+
+		virtual ~Sink() {}
+
+		/**
+		 *	@brief Writes one message without flushing.
+		 *	@param record Finished message record, its text is null-terminated.
+		 *	@param stamp Formatted timestamp of message, empty string if DEBUG_LIB_TIMESTAMP is not defined.
+		 */
+		virtual void write(const Record& record, const char* stamp) = 0;
+
+		/**
+		 *	@brief Flushes written messages.
+		 *	Called once after every batch of messages written to this sink or as decided by DEBUG_LIB_FLUSH_POLICY.
+		 */
+		virtual void flush() = 0;
+	};
+
+	/**
+	 *	@brief Sink that writes messages to a standard stream, for example ::std::cerr.
+	 *	Stream must outlive the sink.
+	 */
+	class StreamSink : public Sink
+	{
+	public:
+
+		explicit StreamSink(::std::ostream& out) : out(out) {}
+
+		void write(const Record& record, const char* stamp) override
+		{
+			out << stamp;
+			out.write(record.data, static_cast<::std::streamsize>(record.size));
+		}
+
+		void flush() override
+		{
+			out.flush();
+		}
+
+	private:
+		::std::ostream& out;
+	};
+
+	/**
+	 *	@brief Sink that appends messages to a file.
+	 */
+	class FileSink : public Sink
+	{
+	public:
+
+		explicit FileSink(const char* name) : file(name, ::std::fstream::app | ::std::fstream::out) {}
+
+		/**
+		 *	@brief Checks whether the file was opened.
+		 */
+		bool is_open() const
+		{
+			return file.is_open();
+		}
+
+		void write(const Record& record, const char* stamp) override
+		{
+			file << stamp;
+			file.write(record.data, static_cast<::std::streamsize>(record.size));
+		}
+
+		void flush() override
+		{
+			file.flush();
+		}
+
+	private:
+		::std::ofstream file;
+
+		FileSink(const FileSink&) = delete;
+		FileSink& operator=(const FileSink&) = delete;
+	};
+
+	/**
+	 *	@brief Identifier of the sink that writes to DEBUG_OUT.
+	 *	It is registered on start for messages of all levels and may be removed or rerouted as any other sink.
+	 */
+	const ::std::size_t DefaultSink = 0;
+
+	/**
+	 *	@brief Registers sink for messages of given level and higher.
+	 *	May be called from any thread, the sink receives messages committed after the call returns.
+	 *	@param sink Sink to be registered, it is kept alive while it is registered and used.
+	 *	@param level Lowest level of messages passed to the sink.
+	 *	@return Identifier of registered sink.
+	 */
+	::std::size_t AddSink(::std::shared_ptr<Sink> sink, Level level);
+
+	/**
+	 *	@brief Unregisters sink. Sink is flushed and released by the thread that writes messages.
+	 *	Messages committed before the call may still be passed to the sink.
+	 *	@return true if sink was removed, false if no sink has given identifier.
+	 */
+	bool RemoveSink(::std::size_t id);
+
+	/**
+	 *	@brief Changes lowest level of messages passed to sink, Level::Nothing pauses the sink.
+	 *	@return true if level was changed, false if no sink has given identifier.
+	 */
+	bool SetSinkLevel(::std::size_t id, Level level);
+}
+
+#endif /* DEBUG_LIB_SINK_HPP__ */
@@ -0,0 +1,133 @@
+#pragma once
+#ifndef DEBUG_LIB_SITE_TABLE_HPP__
+#define DEBUG_LIB_SITE_TABLE_HPP__ "1.0.0@cSiteTable.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains interned message headers of DebugLib text log (See: DEBUG_LIB_SITE_IDS).
+*		Header of every call site is written once to the site table with an identifier derived from
+*		the header text, messages start with this identifier instead of the header.
+*		Formatting and parsing of identifiers are kept together so the offline tools stay in sync with the library.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+
+//	Count of characters of call site identifier "@xxxxxxxx" including the terminating null character
+#define DEBUG_LIB_SITE_ID_TEXT_SIZE 10
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Computes identifier of call site from its header (32-bit FNV-1a).
+	 *	Identifier depends only on the header text, so a header has the same identifier in every run.
+	 *	Different headers may have equal identifiers (See: InternSite).
+	 */
+	inline ::std::uint32_t HashSiteHeader(const char* header)
+	{
+		::std::uint32_t hash = 2166136261u;
+		for (; *header; ++header)
+			hash = (hash ^ static_cast<unsigned char>(*header)) * 16777619u;
+		return hash;
+	}
+
+	/**
+	 *	@brief Formats call site identifier as "@" and 8 lowercase hexadecimal digits.
+	 *	@param out Buffer of at least DEBUG_LIB_SITE_ID_TEXT_SIZE characters.
+	 */
+	inline void FormatSiteId(::std::uint32_t id, char* out)
+	{
+		static const char digits[] = "0123456789abcdef";
+		out[0] = '@';
+		for (int i = 8; i > 0; --i, id >>= 4)
+			out[i] = digits[id & 0xF];
+		out[9] = '\0';
+	}
+
+	/**
+	 *	@brief Recognizes a line that consists of call site identifier only.
+	 *	@param id Receives the identifier.
+	 *	@return true if [line, end) is a call site identifier.
+	 */
+	inline bool ParseSiteId(const char* line, const char* end, ::std::uint32_t& id)
+	{
+		if (end - line != DEBUG_LIB_SITE_ID_TEXT_SIZE - 1 || *line != '@')
+			return false;
+		id = 0;
+		while (++line != end)
+		{
+			const char digit = *line;
+			if (digit >= '0' && digit <= '9')
+				id = id << 4 | static_cast<::std::uint32_t>(digit - '0');
+			else if (digit >= 'a' && digit <= 'f')
+				id = id << 4 | static_cast<::std::uint32_t>(digit - 'a' + 10);
+			else
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 *	@brief Registers call site header in the site table.
+	 *	Header is written to the table once per run. Identifier is never changed to resolve a collision:
+	 *	if another header registered earlier in this run has the same identifier, the site gets no identifier.
+	 *	@param header Static null-terminated first line of message.
+	 *	@param id Receives identifier of call site.
+	 *	@return true if the site has an identifier, false if its messages must keep the header.
+	 */
+	bool InternSite(const char* header, ::std::uint32_t& id);
+
+	/**
+	 *	@brief First line of messages of one call site : its identifier formatted once on registration,
+	 *	or the header itself if the identifier belongs to another header.
+	 *	Registered on the first execution of a message of the call site (static object of the message).
+	 */
+	struct SiteId
+	{
+		explicit SiteId(const char* header) : text(header)
+		{
+			::std::uint32_t id;
+			if (InternSite(header, id))
+			{
+				FormatSiteId(id, buffer);
+				text = buffer;
+			}
+		}
+
+		const char* text;
+		char buffer[DEBUG_LIB_SITE_ID_TEXT_SIZE];
+
+		SiteId(const SiteId&) = delete;
+		SiteId& operator=(const SiteId&) = delete;
+	};
+}
+
+#endif /* DEBUG_LIB_SITE_TABLE_HPP__ */
@@ -0,0 +1,152 @@
+#pragma once
+#ifndef DEBUG_LIB_TIMESTAMP_HPP__
+#define DEBUG_LIB_TIMESTAMP_HPP__ "1.0.0@cTimestamp.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains timestamp counter access and timestamp formatting used by DebugLib.
+*		Records store raw counter values, conversion to wall time is made only by the writer
+*		(See: DEBUG_LIB_TIMESTAMP) or by the offline decoder.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+/// Timestamp counter
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#	include <intrin.h>
+#	define DEBUG_LIB_TSC_X86
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#	include <x86intrin.h>
+#	define DEBUG_LIB_TSC_X86
+#elif defined(__GNUC__) && defined(__aarch64__)
+#	define DEBUG_LIB_TSC_ARM64
+#else
+#	include <chrono>
+#endif
+
+//	Count of characters of formatted timestamp including the terminating null character
+#define DEBUG_LIB_TIMESTAMP_TEXT_SIZE 40
+
+namespace DebugLib
+{
+	/**
+	 *	@brief Reads the timestamp counter of CPU.
+	 *	Uses RDTSC on x86, virtual counter on AArch64 and std::chrono::steady_clock elsewhere.
+	 *	Counter must be invariant and synchronized between cores to order messages of different threads.
+	 */
+	inline ::std::uint64_t ReadTimestampCounter()
+	{
+#if defined(DEBUG_LIB_TSC_X86)
+		return static_cast<::std::uint64_t>(__rdtsc());
+#elif defined(DEBUG_LIB_TSC_ARM64)
+		::std::uint64_t value;
+		asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+		return value;
+#else
+		return static_cast<::std::uint64_t>(::std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	/**
+	 *	@brief Formats wall time in nanoseconds since epoch as "[YYYY-mm-ddTHH:MM:SS.nnnnnnnnnZ] ".
+	 *	Calendar part is computed without library calls, so formatting is async-signal-safe,
+	 *	and is cached and recomputed only when second changes.
+	 *	Must be used by one thread at a time.
+	 */
+	class TimestampFormatter
+	{
+	public:
+
+		TimestampFormatter() : second(~static_cast<::std::uint64_t>(0)), date() {}
+
+		/**
+		 *	@param nanoseconds Wall time in nanoseconds since epoch (UTC).
+		 *	@param out Buffer of at least DEBUG_LIB_TIMESTAMP_TEXT_SIZE characters.
+		 *	@return Count of characters written not counting the terminating null character.
+		 */
+		::std::size_t format(::std::uint64_t nanoseconds, char* out)
+		{
+			const ::std::uint64_t now = nanoseconds / 1000000000u;
+			if (now != second)
+			{
+				formatDate(now);
+				second = now;
+			}
+			::std::memcpy(out, date, DateLength);
+			char* digit = out + DateLength + 9;
+			for (::std::uint32_t fraction = static_cast<::std::uint32_t>(nanoseconds % 1000000000u); digit != out + DateLength; fraction /= 10)
+				*--digit = static_cast<char>('0' + fraction % 10);
+			::std::memcpy(out + DateLength + 9, "Z] ", 4);
+			return DateLength + 12;
+		}
+
+	private:
+		//	Length of "[YYYY-mm-ddTHH:MM:SS."
+		static const ::std::size_t DateLength = 21;
+
+		static void put(char* out, ::std::uint32_t value, int digits)
+		{
+			for (out += digits; digits; --digits, value /= 10)
+				*--out = static_cast<char>('0' + value % 10);
+		}
+
+		/**
+		 *	@brief Converts seconds since epoch to civil date and time of the proleptic Gregorian calendar.
+		 */
+		void formatDate(::std::uint64_t seconds)
+		{
+			const ::std::uint32_t time = static_cast<::std::uint32_t>(seconds % 86400);
+			// Days are counted from 0000-03-01 so leap day is the last day of a year
+			const ::std::uint64_t days = seconds / 86400 + 719468;
+			const ::std::uint64_t era = days / 146097;
+			const ::std::uint32_t dayOfEra = static_cast<::std::uint32_t>(days - era * 146097);
+			const ::std::uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+			const ::std::uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+			const ::std::uint32_t monthIndex = (5 * dayOfYear + 2) / 153;
+			const ::std::uint32_t day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+			const ::std::uint32_t month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+			const ::std::uint32_t year = static_cast<::std::uint32_t>(era * 400 + yearOfEra + (month <= 2 ? 1 : 0));
+			::std::memcpy(date, "[0000-00-00T00:00:00.", DateLength);
+			put(date + 1, year % 10000, 4);
+			put(date + 6, month, 2);
+			put(date + 9, day, 2);
+			put(date + 12, time / 3600, 2);
+			put(date + 15, time / 60 % 60, 2);
+			put(date + 18, time % 60, 2);
+		}
+
+		::std::uint64_t second;
+		char date[DateLength];
+	};
+}
+
+#endif /* DEBUG_LIB_TIMESTAMP_HPP__ */
@@ -0,0 +1,164 @@
+#pragma once
+#ifndef DEBUG_LIB_TRACE_HPP__
+#define DEBUG_LIB_TRACE_HPP__ "1.0.0@cTrace.hpp"
+/**
+*	DESCRIPTION:
+*		Module contains scoped latency tracing of DebugLib (See: DEBUG_LIB_TRACE).
+*		Begin and end of every traced scope are read from the timestamp counter and stored as one event
+*		in the buffer of calling thread. Buffers are drained by the background trace writer that exports
+*		events in the Chrome trace event format.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+*	PAIRED WITH:
+*		Debuglib.cpp
+**/
+/**
+*   MIT License
+*
+*   Copyright (c) 2017-2018 Mikhail Demchenko dev.echo.mike@gmail.com
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+**/
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+/// DebugLib
+#include "cTimestamp.hpp"
+
+//	Size of cache line of target platform in bytes
+#ifndef DEBUG_LIB_CACHE_LINE_SIZE
+#	define DEBUG_LIB_CACHE_LINE_SIZE 64
+#endif
+
+#if DEBUG_LIB_TRACE_BUFFER_SIZE & (DEBUG_LIB_TRACE_BUFFER_SIZE - 1)
+#	error DEBUG_LIB_TRACE_BUFFER_SIZE must be a power of two
+#endif
+
+namespace DebugLib
+{
+	/**
+	 *	@brief One traced scope : timestamp counter values of its begin and end.
+	 */
+	struct TraceEvent
+	{
+		const char* name;
+		::std::uint64_t begin;
+		::std::uint64_t end;
+	};
+
+	/**
+	 *	@brief Ring of trace events of one thread.
+	 *	Only the owner thread adds events and only the trace writer removes them, so no locks are taken.
+	 *	Event that does not fit into a full buffer is dropped and counted.
+	 */
+	struct alignas(DEBUG_LIB_CACHE_LINE_SIZE) TraceBuffer
+	{
+		explicit TraceBuffer(::std::uint32_t thread) :
+			head(0),
+			limit(DEBUG_LIB_TRACE_BUFFER_SIZE),
+			dropped(0),
+			used(true),
+			tail(0),
+			thread(thread)
+		{}
+
+		void push(const char* name, ::std::uint64_t begin, ::std::uint64_t end)
+		{
+			const ::std::uint64_t position = head.load(::std::memory_order_relaxed);
+			// Position of the writer is read again only when the cached limit is reached
+			if (position == limit)
+			{
+				limit = tail.load(::std::memory_order_acquire) + DEBUG_LIB_TRACE_BUFFER_SIZE;
+				if (position == limit)
+				{
+					dropped.store(dropped.load(::std::memory_order_relaxed) + 1, ::std::memory_order_relaxed);
+					return;
+				}
+			}
+			TraceEvent& event = events[position & (DEBUG_LIB_TRACE_BUFFER_SIZE - 1)];
+			event.name = name;
+			event.begin = begin;
+			event.end = end;
+			head.store(position + 1, ::std::memory_order_release);
+		}
+
+		// Written by the owner thread
+		::std::atomic<::std::uint64_t> head;		//!< Count of events added
+		::std::uint64_t limit;						//!< Count of events that may be added without reading tail
+		::std::atomic<::std::uint64_t> dropped;		//!< Count of events that did not fit
+		::std::atomic<bool> used;					//!< Buffer belongs to a running thread
+		// Written by the trace writer
+		alignas(DEBUG_LIB_CACHE_LINE_SIZE) ::std::atomic<::std::uint64_t> tail;	//!< Count of events exported
+		const ::std::uint32_t thread;				//!< Thread identifier in exported events
+		TraceEvent events[DEBUG_LIB_TRACE_BUFFER_SIZE];
+	};
+
+	/**
+	 *	@brief Gives calling thread a buffer that is not used by any running thread.
+	 *	Starts the trace writer on the first call.
+	 */
+	TraceBuffer* AcquireTraceBuffer();
+
+	/**
+	 *	@brief Provides buffer of calling thread.
+	 */
+	inline TraceBuffer& GetTraceBuffer()
+	{
+		static thread_local TraceBuffer* buffer = nullptr;
+		if (!buffer)
+			buffer = AcquireTraceBuffer();
+		return *buffer;
+	}
+
+	/**
+	 *	@brief Adds an event for its own lifetime to the buffer of calling thread.
+	 *	Buffer is taken on construction, so a thread owns its buffer before any of its scopes ends.
+	 */
+	class TraceScope
+	{
+	public:
+
+		/**
+		 *	@param name Null-terminated name of scope, must stay valid until program exit.
+		 */
+		explicit TraceScope(const char* name) :
+			buffer(GetTraceBuffer()),
+			name(name),
+			begin(ReadTimestampCounter())
+		{}
+
+		~TraceScope()
+		{
+			buffer.push(name, begin, ReadTimestampCounter());
+		}
+
+	private:
+		TraceBuffer& buffer;
+		const char* name;
+		const ::std::uint64_t begin;
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+	};
+}
+
+#endif /* DEBUG_LIB_TRACE_HPP__ */
@@ -51,6 +51,17 @@
 /// STD
 #include <cstdlib>
 
+//	Asynchronous and thread buffered outputs, metrics reporter and trace writer threads require thread safety
+#if (defined(DEBUG_LIB_ASYNC) || defined(DEBUG_LIB_THREAD_BUFFER) || defined(DEBUG_LIB_METRICS) || defined(DEBUG_LIB_TRACE)) && !defined(DEBUG_LIB_THREAD_SAFETY)
+#	define DEBUG_LIB_THREAD_SAFETY
+#endif
+
+//	Messages are captured into thread records before output
+#if defined(DEBUG_LIB_ASYNC) || defined(DEBUG_LIB_THREAD_BUFFER) || defined(DEBUG_LIB_BINARY_LOG) || defined(DEBUG_LIB_LOG_INDEX) || \
+	defined(DEBUG_LIB_FLUSH_POLICY) || defined(DEBUG_LIB_TIMESTAMP) || defined(DEBUG_LIB_SINKS)
+#	define DEBUG_LIB_RECORD_OUTPUT
+#endif
+
 #ifdef DEBUG_LIB_THREAD_SAFETY
 /// STD for threads
 #	include <mutex>
@@ -67,8 +78,17 @@ namespace DebugLib
 #	ifndef DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME
 #		define DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME Debug_Lib_Msg_Scope_Lg__
 #	endif
+//	Size of cache line of target platform in bytes
+#	ifndef DEBUG_LIB_CACHE_LINE_SIZE
+#		define DEBUG_LIB_CACHE_LINE_SIZE 64
+#	endif
 #endif /* DEBUG_LIB_THREAD_SAFETY */
 
+//	Global log level variable name macro def : to avoid name conflict
+#ifndef DEBUG_LIB_LOG_LEVEL_VAR_NAME
+#	define DEBUG_LIB_LOG_LEVEL_VAR_NAME Debug_Lib_Log_Level__
+#endif
+
 namespace DebugLib
 {
 	/**
@@ -84,25 +104,55 @@ namespace DebugLib
 		Nothing		//!< Suppress all logging
 	};
 	
+#ifdef DEBUG_LIB_THREAD_SAFETY
+	/**
+	 *	@brief Storage of global log level that occupies a whole cache line.
+	 *	The level is read by every message on every thread, so no other data that may be
+	 *	written is allowed to share its cache line.
+	 */
+	struct alignas(DEBUG_LIB_CACHE_LINE_SIZE) LogLevelStorage
+	{
+		::std::atomic<int> value;
+	};
+
+	/**
+	 *	@brief Current global log level.
+	 *	Defined in DebugLib.cpp, must be accessed only through the log level functions.
+	 */
+	extern LogLevelStorage DEBUG_LIB_LOG_LEVEL_VAR_NAME;
+#else
+	/**
+	 *	@brief Current global log level.
+	 *	Defined in DebugLib.cpp, must be accessed only through the log level functions.
+	 */
+	extern int DEBUG_LIB_LOG_LEVEL_VAR_NAME;
+#endif
+
 	/**
 	 *	@brief Method to obtain read access current global log level.
-	 *	If DEBUG_LIB_THREAD_SAFETY is defined then the read operation is atomic.
+	 *	If DEBUG_LIB_THREAD_SAFETY is defined then the read operation is a relaxed atomic load.
+	 *	Inlined into every start message macro so suppressed messages cost one load and one branch.
 	 *	@return Current global log level.
 	 */
-	DebugLib::Level GetGlobalLogLevel();
+	inline DebugLib::Level GetGlobalLogLevel()
+	{
+#ifdef DEBUG_LIB_THREAD_SAFETY
+		return static_cast<Level>(DEBUG_LIB_LOG_LEVEL_VAR_NAME.value.load(::std::memory_order_relaxed));
+#else
+		return static_cast<Level>(DEBUG_LIB_LOG_LEVEL_VAR_NAME);
+#endif
+	}
 	
 	/**
 	 *	@brief Try to change global log level.
-	 *	If DEBUG_LIB_THREAD_SAFETY is defined then one call to compare_exchange_strong is made.
+	 *	If DEBUG_LIB_THREAD_SAFETY is defined then one call to compare_exchange_strong with release order is made.
 	 *	@return true if level was changed, false otherwise.
 	 */
 	bool try_SetGlobalLogLevel(DebugLib::Level l);
 
 	/**
-	 *	@brief Change global log level (may block).
-	 *	If DEBUG_LIB_THREAD_SAFETY is defined then compare_exchange_weak is called repeatedly until
-	 *	desired log level is set.
-	 *	@return true if level was changed, false otherwise.
+	 *	@brief Change global log level.
+	 *	If DEBUG_LIB_THREAD_SAFETY is defined then the write operation is an atomic store with release order.
 	 */
 	void SetGlobalLogLevel(DebugLib::Level l);
 }
@@ -110,9 +160,135 @@ namespace DebugLib
 #	define DEBUG_LIB_DEFAULT_LOG_LEVEL ::DebugLib::Level::All
 #endif
 
+//	Messages with lower level are removed at compile time : must be an integer value of one of DebugLib::Level members
+#ifndef DEBUG_LIB_MIN_LEVEL
+#	define DEBUG_LIB_MIN_LEVEL 0
+#endif
+#if DEBUG_LIB_MIN_LEVEL < 0 || DEBUG_LIB_MIN_LEVEL > 4
+#	error DEBUG_LIB_MIN_LEVEL must be an integer value of one of DebugLib::Level members
+#endif
+
+#ifdef DEBUG_LIB_MODULE_LEVELS
+/// STD for module levels
+#	include <cstddef>
+#	include <cstdint>
+//	Count of slots in module level table : must be a power of two
+#	ifndef DEBUG_LIB_MODULE_COUNT
+#		define DEBUG_LIB_MODULE_COUNT 256
+#	endif
+#	if DEBUG_LIB_MODULE_COUNT < 1 || (DEBUG_LIB_MODULE_COUNT & (DEBUG_LIB_MODULE_COUNT - 1)) != 0
+#		error DEBUG_LIB_MODULE_COUNT must be a power of two
+#	endif
+//	Module level table variable name macro def : to avoid name conflict
+#	ifndef DEBUG_LIB_MODULE_LEVELS_VAR_NAME
+#		define DEBUG_LIB_MODULE_LEVELS_VAR_NAME Debug_Lib_Module_Levels__
+#	endif
+//	Module of messages at the point of use : compile-time hash of source file name by default
+#	ifndef DEBUG_LIB_MODULE
+#		define DEBUG_LIB_MODULE ::DebugLib::ModuleOf(__FILE__)
+#	endif
+namespace DebugLib
+{
+	/**
+	 *	@brief FNV-1a hash of a null-terminated string that may be evaluated at compile time.
+	 */
+	constexpr ::std::uint32_t ModuleHash(const char* name, ::std::uint32_t hash = 2166136261u)
+	{
+		return *name ? ModuleHash(name + 1, (hash ^ static_cast<unsigned char>(*name)) * 16777619u) : hash;
+	}
+
+	/**
+	 *	@brief Slot of module level table that is used by messages of given source file.
+	 *	@param name Source file name exactly as it is expanded from __FILE__ in that file.
+	 */
+	constexpr ::std::size_t ModuleOf(const char* name)
+	{
+		return ModuleHash(name) & (DEBUG_LIB_MODULE_COUNT - 1);
+	}
+
+#	ifdef DEBUG_LIB_THREAD_SAFETY
+	/**
+	 *	@brief Levels of modules : zero means that module uses global log level, level plus one otherwise.
+	 *	Defined in DebugLib.cpp, must be accessed only through the module level functions.
+	 */
+	extern ::std::atomic<int> DEBUG_LIB_MODULE_LEVELS_VAR_NAME[DEBUG_LIB_MODULE_COUNT];
+#	else
+	/**
+	 *	@brief Levels of modules : zero means that module uses global log level, level plus one otherwise.
+	 *	Defined in DebugLib.cpp, must be accessed only through the module level functions.
+	 */
+	extern int DEBUG_LIB_MODULE_LEVELS_VAR_NAME[DEBUG_LIB_MODULE_COUNT];
+#	endif
+
+	/**
+	 *	@brief Method to obtain read access to the level of module.
+	 *	If DEBUG_LIB_THREAD_SAFETY is defined then the read operation is a relaxed atomic load.
+	 *	@param module Slot of module level table, taken modulo DEBUG_LIB_MODULE_COUNT.
+	 *	@return Level of module or global log level if module has no own level.
+	 */
+	inline DebugLib::Level GetModuleLogLevel(::std::size_t module)
+	{
+#	ifdef DEBUG_LIB_THREAD_SAFETY
+		const int stored = DEBUG_LIB_MODULE_LEVELS_VAR_NAME[module & (DEBUG_LIB_MODULE_COUNT - 1)].load(::std::memory_order_relaxed);
+#	else
+		const int stored = DEBUG_LIB_MODULE_LEVELS_VAR_NAME[module & (DEBUG_LIB_MODULE_COUNT - 1)];
+#	endif
+		return stored ? static_cast<Level>(stored - 1) : GetGlobalLogLevel();
+	}
+
+	/**
+	 *	@brief Level check of start message macros.
+	 *	Module is a template argument so the table index is a compile-time constant.
+	 */
+	template < ::std::size_t Module >
+	inline bool IsModuleLevelEnabled(DebugLib::Level level)
+	{
+		static_assert(Module < DEBUG_LIB_MODULE_COUNT, "DEBUG_LIB_MODULE must be less than DEBUG_LIB_MODULE_COUNT");
+		return GetModuleLogLevel(Module) <= level;
+	}
+
+	/**
+	 *	@brief Change level of module.
+	 *	If DEBUG_LIB_THREAD_SAFETY is defined then the write operation is an atomic store with release order.
+	 *	@return true if level was changed, false if module is out of table.
+	 */
+	bool SetModuleLogLevel(::std::size_t module, DebugLib::Level l);
+
+	/**
+	 *	@brief Makes module use global log level again.
+	 *	@return true if level was changed, false if module is out of table.
+	 */
+	bool ResetModuleLogLevel(::std::size_t module);
+}
+#	define DEBUG_LIB_LEVEL_ENABLED(level) (::DebugLib::IsModuleLevelEnabled<DEBUG_LIB_MODULE>(level))
+#else
+#	define DEBUG_LIB_LEVEL_ENABLED(level) (::DebugLib::GetGlobalLogLevel() <= level)
+#endif /* DEBUG_LIB_MODULE_LEVELS */
+
+//	Checks of message level : constant false for levels below DEBUG_LIB_MIN_LEVEL
+#if DEBUG_LIB_MIN_LEVEL <= 0
+#	define DEBUG_LIB_INFO_ENABLED DEBUG_LIB_LEVEL_ENABLED(::DebugLib::Level::Info)
+#else
+#	define DEBUG_LIB_INFO_ENABLED false
+#endif
+#if DEBUG_LIB_MIN_LEVEL <= 1
+#	define DEBUG_LIB_WARNING_ENABLED DEBUG_LIB_LEVEL_ENABLED(::DebugLib::Level::Warning)
+#else
+#	define DEBUG_LIB_WARNING_ENABLED false
+#endif
+#if DEBUG_LIB_MIN_LEVEL <= 2
+#	define DEBUG_LIB_ERROR_ENABLED DEBUG_LIB_LEVEL_ENABLED(::DebugLib::Level::Error)
+#else
+#	define DEBUG_LIB_ERROR_ENABLED false
+#endif
+#if DEBUG_LIB_MIN_LEVEL <= 3
+#	define DEBUG_LIB_USER_ENABLED DEBUG_LIB_LEVEL_ENABLED(::DebugLib::Level::User)
+#else
+#	define DEBUG_LIB_USER_ENABLED false
+#endif
+
 #ifdef DEBUG_LIB_FILE_LOG
 #	ifndef DEBUG_OUT
-#		include <fstream>
 //		Output variable name macro def : avoids name conflict
 #		ifndef DEBUG_LIB_LOG_FILE_VAR_NAME
 #			define DEBUG_LIB_LOG_FILE_VAR_NAME Debug_Lib_Log_File__
@@ -121,36 +297,265 @@ namespace DebugLib
 #		ifndef DEBUG_LIB_LOG_FILE_NAME
 #			define DEBUG_LIB_LOG_FILE_NAME "log.dat"
 #		endif
+#		ifdef DEBUG_LIB_MMAP_LOG
+//			Log file grows by chunks of this size in bytes : rounded up to the page size
+#			ifndef DEBUG_LIB_MMAP_CHUNK_SIZE
+#				define DEBUG_LIB_MMAP_CHUNK_SIZE (1 << 20)
+#			endif
+#		endif
+#		ifdef DEBUG_LIB_LOG_ROTATION
+#			if defined(DEBUG_LIB_MMAP_LOG) || defined(DEBUG_LIB_LOG_INDEX) || defined(DEBUG_LIB_BINARY_LOG)
+#				error DEBUG_LIB_LOG_ROTATION is not supported together with DEBUG_LIB_MMAP_LOG, DEBUG_LIB_LOG_INDEX or DEBUG_LIB_BINARY_LOG
+#			endif
+//			Log file is rotated when it reaches this size in bytes : 0 disables rotation by size
+#			ifndef DEBUG_LIB_LOG_ROTATION_SIZE
+#				define DEBUG_LIB_LOG_ROTATION_SIZE (64ull << 20)
+#			endif
+//			Log file is rotated after this count of seconds : 0 disables rotation by time
+#			ifndef DEBUG_LIB_LOG_ROTATION_PERIOD
+#				define DEBUG_LIB_LOG_ROTATION_PERIOD 0
+#			endif
+//			Closed log segments are compressed to LZ4 frames : 0 leaves them as is
+#			ifndef DEBUG_LIB_LOG_ROTATION_COMPRESS
+#				define DEBUG_LIB_LOG_ROTATION_COMPRESS 1
+#			endif
+#		endif
+#		if defined(DEBUG_LIB_MMAP_LOG) || defined(DEBUG_LIB_LOG_ROTATION) || defined(DEBUG_LIB_CRASH_DRAIN) || defined(DEBUG_LIB_WRITEV)
+#			include <ostream>
+		namespace DebugLib 
+		{
+			extern ::std::ostream DEBUG_LIB_LOG_FILE_VAR_NAME;
+		}
+#		else
+#			include <fstream>
 		namespace DebugLib 
 		{
 			extern ::std::ofstream DEBUG_LIB_LOG_FILE_VAR_NAME;
 		}
+#		endif
 #		define DEBUG_OUT ::DebugLib::DEBUG_LIB_LOG_FILE_VAR_NAME
 #	endif
+#elif defined(DEBUG_LIB_MMAP_LOG) || defined(DEBUG_LIB_LOG_ROTATION)
+#	error DEBUG_LIB_MMAP_LOG and DEBUG_LIB_LOG_ROTATION require DEBUG_LIB_FILE_LOG
 #else
 #	include <iostream>
-/*
-//	Output stream for INFO messages
-#	ifndef DEBUG_LIB_INFO_OUT
-#		define DEBUG_LIB_INFO_OUT ::std::clog
+#	ifndef DEBUG_OUT
+#		define DEBUG_OUT ::std::clog
 #	endif
-//	Output stream for WARNING messages
-#	ifndef DEBUG_LIB_WARNING_OUT
-#		define DEBUG_LIB_WARNING_OUT ::std::cout
+#endif /* DEBUG_LIB_FILE_LOG */
+
+#ifdef DEBUG_LIB_LOG_INDEX
+#	ifndef DEBUG_LIB_FILE_LOG
+#		error DEBUG_LIB_LOG_INDEX requires DEBUG_LIB_FILE_LOG
 #	endif
-//	Output stream for ERROR messages
-#	ifndef DEBUG_LIB_ERROR_OUT
-#		define DEBUG_LIB_ERROR_OUT ::std::cerr
+#	ifdef DEBUG_LIB_BINARY_LOG
+#		error DEBUG_LIB_LOG_INDEX is not supported for DEBUG_LIB_BINARY_LOG
 #	endif
-//	Output stream for USER messages
-#	ifndef DEBUG_LIB_USER_OUT
-#		define DEBUG_LIB_USER_OUT ::std::clog
+//	Sidecar index file path + name
+#	ifndef DEBUG_LIB_LOG_INDEX_FILE_NAME
+#		define DEBUG_LIB_LOG_INDEX_FILE_NAME DEBUG_LIB_LOG_FILE_NAME ".idx"
 #	endif
-//*/
-#	ifndef DEBUG_OUT
-#		define DEBUG_OUT ::std::clog
+#endif /* DEBUG_LIB_LOG_INDEX */
+
+#if defined(DEBUG_LIB_TIMESTAMP) || defined(DEBUG_LIB_TRACE)
+//	Time in milliseconds during which timestamp counter is calibrated against steady clock
+#	ifndef DEBUG_LIB_TIMESTAMP_CALIBRATION
+#		define DEBUG_LIB_TIMESTAMP_CALIBRATION 20
 #	endif
-#endif /* DEBUG_LIB_FILE_LOG */
+#endif /* DEBUG_LIB_TIMESTAMP || DEBUG_LIB_TRACE */
+
+#ifdef DEBUG_LIB_RECORD_OUTPUT
+#	include "cRecord.hpp"
+//	Message record variable name macro def : to avoid name conflict
+#	ifndef DEBUG_LIB_RECORD_VAR_NAME
+#		define DEBUG_LIB_RECORD_VAR_NAME Debug_Lib_Msg_Record__
+#	endif
+#endif /* DEBUG_LIB_RECORD_OUTPUT */
+
+#ifdef DEBUG_LIB_BINARY_LOG
+#	include "cBinaryRecord.hpp"
+//	Call site identifier variable name macro def : to avoid name conflict
+#	ifndef DEBUG_LIB_SITE_VAR_NAME
+#		define DEBUG_LIB_SITE_VAR_NAME Debug_Lib_Msg_Site__
+#	endif
+#endif /* DEBUG_LIB_BINARY_LOG */
+
+//	Binary log always stores call site identifiers instead of headers
+#if defined(DEBUG_LIB_SITE_IDS) && !defined(DEBUG_LIB_BINARY_LOG)
+#	include "cSiteTable.hpp"
+//	Site table file path + name
+#	ifndef DEBUG_LIB_SITE_TABLE_FILE_NAME
+#		ifdef DEBUG_LIB_FILE_LOG
+#			define DEBUG_LIB_SITE_TABLE_FILE_NAME DEBUG_LIB_LOG_FILE_NAME ".sites"
+#		else
+#			define DEBUG_LIB_SITE_TABLE_FILE_NAME "sites.txt"
+#		endif
+#	endif
+//	Call site identifier variable name macro def : to avoid name conflict
+#	ifndef DEBUG_LIB_SITE_VAR_NAME
+#		define DEBUG_LIB_SITE_VAR_NAME Debug_Lib_Msg_Site__
+#	endif
+#endif /* DEBUG_LIB_SITE_IDS && !DEBUG_LIB_BINARY_LOG */
+
+#ifdef DEBUG_LIB_SINKS
+#	if defined(DEBUG_LIB_BINARY_LOG) || defined(DEBUG_LIB_LOG_INDEX) || defined(DEBUG_LIB_WRITEV)
+#		error DEBUG_LIB_SINKS is not supported together with DEBUG_LIB_BINARY_LOG, DEBUG_LIB_LOG_INDEX or DEBUG_LIB_WRITEV
+#	endif
+//	Messages are routed by level to sinks registered at runtime : DEBUG_OUT is one of them
+#	include "cSink.hpp"
+#endif /* DEBUG_LIB_SINKS */
+
+#ifdef DEBUG_LIB_ASYNC
+namespace DebugLib
+{
+	/**
+	 *	Defines what happens to a message when asynchronous output queue is full.
+	 */
+	enum OverflowPolicy : int
+	{
+		Block,			//!< Producer waits until the writer frees a slot
+		DropNewest,		//!< Message being committed is discarded
+		DropOldest,		//!< Oldest queued message is discarded to free a slot
+		DropAfterWait	//!< Producer waits at most DEBUG_LIB_ASYNC_OVERFLOW_WAIT for a slot, then message is discarded
+	};
+
+	/**
+	 *	@brief Method to obtain count of messages discarded due to full asynchronous output queue.
+	 *	@return Count of discarded messages since program start.
+	 */
+	::std::size_t GetDroppedMessagesCount();
+
+	/**
+	 *	@brief Method to obtain count of messages of one level discarded due to full asynchronous output queue.
+	 *	@return Count of discarded messages of given level since program start, 0 for Level::Nothing.
+	 */
+	::std::size_t GetDroppedMessagesCount(Level level);
+}
+//	Count of records that asynchronous output queue can hold : must be a power of two
+#	ifndef DEBUG_LIB_ASYNC_QUEUE_SIZE
+#		define DEBUG_LIB_ASYNC_QUEUE_SIZE 1024
+#	endif
+//	Behaviour of producers on full asynchronous output queue
+#	ifndef DEBUG_LIB_ASYNC_OVERFLOW_POLICY
+#		define DEBUG_LIB_ASYNC_OVERFLOW_POLICY ::DebugLib::OverflowPolicy::Block
+#	endif
+//	Maximal time in microseconds that producer waits for a free slot with OverflowPolicy::DropAfterWait
+#	ifndef DEBUG_LIB_ASYNC_OVERFLOW_WAIT
+#		define DEBUG_LIB_ASYNC_OVERFLOW_WAIT 100
+#	endif
+//	Maximal time in milliseconds that idle background writer sleeps between queue checks
+#	ifndef DEBUG_LIB_ASYNC_IDLE_WAIT
+#		define DEBUG_LIB_ASYNC_IDLE_WAIT 10
+#	endif
+#endif /* DEBUG_LIB_ASYNC */
+
+#ifdef DEBUG_LIB_WRITEV
+#	ifndef DEBUG_LIB_ASYNC
+#		error DEBUG_LIB_WRITEV requires DEBUG_LIB_ASYNC
+#	endif
+#	if defined(DEBUG_LIB_BINARY_LOG) || defined(DEBUG_LIB_LOG_INDEX) || defined(DEBUG_LIB_MMAP_LOG) || defined(DEBUG_LIB_LOG_ROTATION) || defined(DEBUG_LIB_FLUSH_POLICY)
+#		error DEBUG_LIB_WRITEV is not supported together with other output modes that own the log file or its flushing
+#	endif
+//	Maximal count of records submitted by one writev call
+#	ifndef DEBUG_LIB_WRITEV_BATCH
+#		define DEBUG_LIB_WRITEV_BATCH 64
+#	endif
+//	Records of a batch keep their queue slots until it is written
+#	if DEBUG_LIB_WRITEV_BATCH > DEBUG_LIB_ASYNC_QUEUE_SIZE
+#		error DEBUG_LIB_WRITEV_BATCH must not exceed DEBUG_LIB_ASYNC_QUEUE_SIZE
+#	endif
+//	Maximal time in microseconds that background writer waits to fill a batch
+#	ifndef DEBUG_LIB_WRITEV_DELAY
+#		define DEBUG_LIB_WRITEV_DELAY 1000
+#	endif
+#endif /* DEBUG_LIB_WRITEV */
+
+#ifdef DEBUG_LIB_FLUSH_POLICY
+//	Output is flushed after this count of messages : 0 disables the condition
+#	ifndef DEBUG_LIB_FLUSH_MESSAGES
+#		define DEBUG_LIB_FLUSH_MESSAGES 0
+#	endif
+//	Output is flushed after this count of bytes : 0 disables the condition
+#	ifndef DEBUG_LIB_FLUSH_BYTES
+#		define DEBUG_LIB_FLUSH_BYTES (64 * 1024)
+#	endif
+//	Output is flushed if it was not flushed for this count of milliseconds : 0 disables the condition
+#	ifndef DEBUG_LIB_FLUSH_PERIOD
+#		define DEBUG_LIB_FLUSH_PERIOD 1000
+#	endif
+//	Output is flushed right after messages of this level and higher
+#	ifndef DEBUG_LIB_FLUSH_LEVEL
+#		define DEBUG_LIB_FLUSH_LEVEL ::DebugLib::Level::Error
+#	endif
+#endif /* DEBUG_LIB_FLUSH_POLICY */
+
+#ifdef DEBUG_LIB_CRASH_DRAIN
+#	if defined(DEBUG_LIB_BINARY_LOG) || defined(DEBUG_LIB_MMAP_LOG) || defined(DEBUG_LIB_LOG_ROTATION)
+#		error DEBUG_LIB_CRASH_DRAIN is not supported together with DEBUG_LIB_BINARY_LOG, DEBUG_LIB_MMAP_LOG or DEBUG_LIB_LOG_ROTATION
+#	endif
+#	if !defined(DEBUG_LIB_FILE_LOG) && !defined(DEBUG_LIB_ASYNC)
+#		error DEBUG_LIB_CRASH_DRAIN requires DEBUG_LIB_FILE_LOG or DEBUG_LIB_ASYNC : buffers of DEBUG_OUT cannot be drained
+#	endif
+namespace DebugLib
+{
+	/**
+	 *	@brief Writes output held by DebugLib buffers and queue to the log with raw write calls.
+	 *	Async-signal-safe : may be called from a fatal signal handler installed by user.
+	 *	Only the first call writes, concurrent calls wait until it finishes.
+	 */
+	void DrainPendingOutput();
+}
+//	Size of the log file buffer in bytes : buffered output is written by fatal signal handler
+#	ifndef DEBUG_LIB_CRASH_BUFFER_SIZE
+#		define DEBUG_LIB_CRASH_BUFFER_SIZE (64 * 1024)
+#	endif
+//	Size of alternate signal stack of the thread that initializes DebugLib in bytes : 0 disables it
+#	ifndef DEBUG_LIB_CRASH_STACK_SIZE
+#		define DEBUG_LIB_CRASH_STACK_SIZE (64 * 1024)
+#	endif
+#endif /* DEBUG_LIB_CRASH_DRAIN */
+
+#ifdef DEBUG_LIB_METRICS
+//	Count of counter slots in the shard of every thread : a counter takes one slot, a histogram takes 66
+#	ifndef DEBUG_LIB_METRICS_SLOTS
+#		define DEBUG_LIB_METRICS_SLOTS 1024
+#	endif
+//	Count of gauges
+#	ifndef DEBUG_LIB_METRICS_GAUGES
+#		define DEBUG_LIB_METRICS_GAUGES 64
+#	endif
+//	Time in milliseconds between two snapshots of metrics : 0 writes only the snapshot on exit
+#	ifndef DEBUG_LIB_METRICS_PERIOD
+#		define DEBUG_LIB_METRICS_PERIOD 10000
+#	endif
+//	Metric identifier variable name macro def : to avoid name conflict
+#	ifndef DEBUG_LIB_METRIC_VAR_NAME
+#		define DEBUG_LIB_METRIC_VAR_NAME Debug_Lib_Metric__
+#	endif
+//	Gauge values variable name macro def : to avoid name conflict
+#	ifndef DEBUG_LIB_METRIC_GAUGES_VAR_NAME
+#		define DEBUG_LIB_METRIC_GAUGES_VAR_NAME Debug_Lib_Metric_Gauges__
+#	endif
+#endif /* DEBUG_LIB_METRICS */
+
+#ifdef DEBUG_LIB_TRACE
+//	Trace file path + name : JSON array of Chrome trace events
+#	ifndef DEBUG_LIB_TRACE_FILE_NAME
+#		define DEBUG_LIB_TRACE_FILE_NAME "trace.json"
+#	endif
+//	Count of events in the buffer of every thread : must be a power of two, events that do not fit are dropped
+#	ifndef DEBUG_LIB_TRACE_BUFFER_SIZE
+#		define DEBUG_LIB_TRACE_BUFFER_SIZE 4096
+#	endif
+//	Time in milliseconds between two exports of trace events : 0 exports events only on exit
+#	ifndef DEBUG_LIB_TRACE_PERIOD
+#		define DEBUG_LIB_TRACE_PERIOD 100
+#	endif
+//	Trace scope variable name macro def : to avoid name conflict, line number is appended
+#	ifndef DEBUG_LIB_TRACE_SCOPE_VAR_NAME
+#		define DEBUG_LIB_TRACE_SCOPE_VAR_NAME Debug_Lib_Trace_Scope__
+#	endif
+#endif /* DEBUG_LIB_TRACE */
 
 // New line definition
 #ifndef DEBUG_LIB_NEXT_LINE
@@ -162,48 +567,81 @@ namespace DebugLib
 #	define DEBUG_LIB_FLUSH ::std::flush
 #endif /* DEBUG_LIB_FLUSH */
 
-// Selector macro set
-#define DEBUG_LIB_GET_MACRO_4(_1, _2, _3, _4, NAME, ...) NAME
-#define DEBUG_LIB_GET_MACRO_5(_1, _2, _3, _4, _5, NAME, ...) NAME
-#ifdef _MSC_VER
-// MSVC PP is not same as other PP
-#	define DEBUG_LIB_EXPAND( x ) x
+/* Message scope macro set */
+
+#if defined(DEBUG_LIB_SITE_IDS) && !defined(DEBUG_LIB_BINARY_LOG)
+//	First line of message with header : identifier of call site, header is written to the site table on the first
+//	execution of the message
+#	define DEBUG_LIB_MESSAGE_HEADER(header) \
+		static const ::DebugLib::SiteId DEBUG_LIB_SITE_VAR_NAME(header); \
+		DEBUG_PRINT1(DEBUG_LIB_SITE_VAR_NAME.text);
+#else
+//	First line of message with header : the header itself
+#	define DEBUG_LIB_MESSAGE_HEADER(header) DEBUG_PRINT1(header);
+#endif
+
+#if defined(DEBUG_LIB_BINARY_LOG)
+//	Output of current message : binary record of calling thread
+#	define DEBUG_LIB_MESSAGE_OUT DEBUG_LIB_RECORD_VAR_NAME
+//	Inner scope prologue : registers call site once and starts capturing to thread record
+#	define DEBUG_LIB_MESSAGE_BEGIN(level, header) \
+		static const ::std::uint32_t DEBUG_LIB_SITE_VAR_NAME = ::DebugLib::RegisterSite(header); \
+		::DebugLib::BinaryRecordStream& DEBUG_LIB_RECORD_VAR_NAME = ::DebugLib::OpenBinaryRecord(level, DEBUG_LIB_SITE_VAR_NAME);
+//	Inner scope prologue with header : header is stored once with call site
+#	define DEBUG_LIB_MESSAGE_OPEN(level, header) DEBUG_LIB_MESSAGE_BEGIN(level, header)
+//	Inner scope epilogue : passes captured record to output
+#	define DEBUG_LIB_MESSAGE_CLOSE ::DebugLib::CommitRecord(DEBUG_LIB_RECORD_VAR_NAME);
+#elif defined(DEBUG_LIB_RECORD_OUTPUT)
+//	Output of current message : record of calling thread
+#	define DEBUG_LIB_MESSAGE_OUT DEBUG_LIB_RECORD_VAR_NAME
+//	Inner scope prologue : starts capturing to thread record
+#	define DEBUG_LIB_MESSAGE_BEGIN(level, header) ::DebugLib::RecordStream& DEBUG_LIB_RECORD_VAR_NAME = ::DebugLib::OpenRecord(level, header);
+//	Inner scope prologue with header : header is the first line of message
+#	define DEBUG_LIB_MESSAGE_OPEN(level, header) DEBUG_LIB_MESSAGE_BEGIN(level, header) DEBUG_LIB_MESSAGE_HEADER(header)
+//	Inner scope epilogue : passes captured record to output
+#	define DEBUG_LIB_MESSAGE_CLOSE ::DebugLib::CommitRecord(DEBUG_LIB_RECORD_VAR_NAME);
+#elif defined(DEBUG_LIB_THREAD_SAFETY)
+#	define DEBUG_LIB_MESSAGE_OUT DEBUG_OUT
+#	define DEBUG_LIB_MESSAGE_BEGIN(level, header) ::std::lock_guard<::std::mutex> DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME(::DebugLib::DEBUG_LIB_MUTEX_VAR_NAME);
+#	define DEBUG_LIB_MESSAGE_OPEN(level, header) DEBUG_LIB_MESSAGE_BEGIN(level, header) DEBUG_LIB_MESSAGE_HEADER(header)
+#	define DEBUG_LIB_MESSAGE_CLOSE DEBUG_OUT << DEBUG_LIB_FLUSH;
+#else
+#	define DEBUG_LIB_MESSAGE_OUT DEBUG_OUT
+#	define DEBUG_LIB_MESSAGE_BEGIN(level, header)
+#	define DEBUG_LIB_MESSAGE_OPEN(level, header) DEBUG_LIB_MESSAGE_HEADER(header)
+#	define DEBUG_LIB_MESSAGE_CLOSE DEBUG_OUT << DEBUG_LIB_FLUSH;
 #endif
 
 /* Output macro set */
 
 #ifdef DEBUG
+#	include "cRecord.hpp"
+#	include "cKeyValue.hpp"
 //	Debug write macro
 //	Allow to output one value to debug stream without new line afterwards.
-#	define DEBUG_WRITE1(x) DEBUG_OUT << (x)
+#	define DEBUG_WRITE1(x) DEBUG_LIB_MESSAGE_OUT << (x)
 //	Allow to output two values to debug stream without new line afterwards.
-#	define DEBUG_WRITE2(x, y) DEBUG_OUT << (x) << (y)
+#	define DEBUG_WRITE2(x, y) DEBUG_LIB_MESSAGE_OUT << (x) << (y)
 //	Allow to output three values to debug stream without new line afterwards.
-#	define DEBUG_WRITE3(x, y, z) DEBUG_OUT << (x) << (y) << (z)
+#	define DEBUG_WRITE3(x, y, z) DEBUG_LIB_MESSAGE_OUT << (x) << (y) << (z)
 //	Allow to output four values to debug stream without new line afterwards.
-#	define DEBUG_WRITE4(x, y, z, w) DEBUG_OUT << (x) << (y) << (z) << (w)
+#	define DEBUG_WRITE4(x, y, z, w) DEBUG_LIB_MESSAGE_OUT << (x) << (y) << (z) << (w)
 //	Allow to output four values to debug stream without new line afterwards.
-#	define DEBUG_WRITE5(x, y, z, w, h) DEBUG_OUT << (x) << (y) << (z) << (w) << (h)
-//	Auto select between DEBUG_WRITEN macros set
-#	ifdef _MSC_VER
-#		define DEBUG_WRITE(...) DEBUG_LIB_EXPAND(DEBUG_LIB_GET_MACRO_5(__VA_ARGS__, DEBUG_WRITE5, DEBUG_WRITE4, DEBUG_WRITE3, DEBUG_WRITE2, DEBUG_WRITE1)(__VA_ARGS__))
-#	else
-#		define DEBUG_WRITE(...) DEBUG_LIB_GET_MACRO_5(__VA_ARGS__, DEBUG_WRITE5, DEBUG_WRITE4, DEBUG_WRITE3, DEBUG_WRITE2, DEBUG_WRITE1)(__VA_ARGS__)
-#endif
+#	define DEBUG_WRITE5(x, y, z, w, h) DEBUG_LIB_MESSAGE_OUT << (x) << (y) << (z) << (w) << (h)
+//	Allow to output any count of values to debug stream without new line afterwards : one operator<< call per value
+#	define DEBUG_WRITE(...) ((void)(::DebugLib::WriteValues(DEBUG_LIB_MESSAGE_OUT), __VA_ARGS__))
 //	Allow to output one value to debug stream with new line afterwards.
-#	define DEBUG_PRINT1(x) DEBUG_OUT << (x) << DEBUG_LIB_NEXT_LINE
+#	define DEBUG_PRINT1(x) DEBUG_LIB_MESSAGE_OUT << (x) << DEBUG_LIB_NEXT_LINE
 //	Allow to output two values to debug stream with new line afterwards
-#	define DEBUG_PRINT2(x, y) DEBUG_OUT << (x) << (y) << DEBUG_LIB_NEXT_LINE
+#	define DEBUG_PRINT2(x, y) DEBUG_LIB_MESSAGE_OUT << (x) << (y) << DEBUG_LIB_NEXT_LINE
 //	Allow to output three values to debug stream with new line afterwards.
-#	define DEBUG_PRINT3(x, y, z) DEBUG_OUT << (x) << (y) << (z) << DEBUG_LIB_NEXT_LINE
+#	define DEBUG_PRINT3(x, y, z) DEBUG_LIB_MESSAGE_OUT << (x) << (y) << (z) << DEBUG_LIB_NEXT_LINE
 //	Allow to output four values to debug stream with new line afterwards.
-#	define DEBUG_PRINT4(x, y, z, w) DEBUG_OUT << (x) << (y) << (z) << (w) << DEBUG_LIB_NEXT_LINE
-//	Auto select between DEBUG_PRINTN macros set
-#	ifdef _MSC_VER
-#		define DEBUG_PRINT(...) DEBUG_LIB_EXPAND(DEBUG_LIB_GET_MACRO_4(__VA_ARGS__, DEBUG_PRINT4, DEBUG_PRINT3, DEBUG_PRINT2, DEBUG_PRINT1)(__VA_ARGS__))
-#	else
-#		define DEBUG_PRINT(...) DEBUG_LIB_GET_MACRO_4(__VA_ARGS__, DEBUG_PRINT4, DEBUG_PRINT3, DEBUG_PRINT2, DEBUG_PRINT1)(__VA_ARGS__)
-#endif
+#	define DEBUG_PRINT4(x, y, z, w) DEBUG_LIB_MESSAGE_OUT << (x) << (y) << (z) << (w) << DEBUG_LIB_NEXT_LINE
+//	Allow to output any count of values to debug stream with new line afterwards : one operator<< call per value
+#	define DEBUG_PRINT(...) ((void)(::DebugLib::WriteValues(DEBUG_LIB_MESSAGE_OUT), __VA_ARGS__, DEBUG_LIB_NEXT_LINE))
+//	Allow to output pairs of key and value as one line of structured fields (JSON object or binary object argument).
+#	define DEBUG_KV(...) ::DebugLib::WriteKeyValues(DEBUG_LIB_MESSAGE_OUT, __VA_ARGS__) << DEBUG_LIB_NEXT_LINE
 #else
 #	define DEBUG_WRITE1(x) {}
 #	define DEBUG_WRITE2(x,y) {}
@@ -216,35 +654,97 @@ namespace DebugLib
 #	define DEBUG_PRINT3(x,y,z) {}
 #	define DEBUG_PRINT4(x,y,z,w) {}
 #	define DEBUG_PRINT(...) {}
+#	define DEBUG_KV(...) {}
 #endif /* DEBUG */
 
+/* Metrics macro set */
+
+#if defined(DEBUG) && defined(DEBUG_LIB_METRICS)
+#	include "cMetrics.hpp"
+//	Identifier of metric of call site : registered once, name must be a constant
+#	define DEBUG_LIB_METRIC(name, kind) \
+	([]() -> ::std::uint32_t { static const ::std::uint32_t DEBUG_LIB_METRIC_VAR_NAME = ::DebugLib::RegisterMetric(name, kind); return DEBUG_LIB_METRIC_VAR_NAME; }())
+//	Adds non-negative value to named counter.
+#	define DEBUG_COUNTER_ADD(name, value) ::DebugLib::AddCounter(DEBUG_LIB_METRIC(name, ::DebugLib::MetricKind::Counter), static_cast<::std::uint64_t>(value))
+//	Adds one to named counter.
+#	define DEBUG_COUNTER_INC(name) DEBUG_COUNTER_ADD(name, 1)
+//	Sets value of named gauge.
+#	define DEBUG_GAUGE_SET(name, value) ::DebugLib::SetGauge(DEBUG_LIB_METRIC(name, ::DebugLib::MetricKind::Gauge), static_cast<::std::int64_t>(value))
+//	Adds non-negative value (for example latency in nanoseconds) to named histogram.
+#	define DEBUG_HISTOGRAM_RECORD(name, value) ::DebugLib::RecordHistogram(DEBUG_LIB_METRIC(name, ::DebugLib::MetricKind::Histogram), static_cast<::std::uint64_t>(value))
+#else
+#	define DEBUG_COUNTER_ADD(name, value) ((void)0)
+#	define DEBUG_COUNTER_INC(name) ((void)0)
+#	define DEBUG_GAUGE_SET(name, value) ((void)0)
+#	define DEBUG_HISTOGRAM_RECORD(name, value) ((void)0)
+#endif /* DEBUG && DEBUG_LIB_METRICS */
+
+/* Trace macro set */
+
+#if defined(DEBUG) && defined(DEBUG_LIB_TRACE)
+#	include "cTrace.hpp"
+//	Allows to use line number in variable names
+#	define DEBUG_LIB_CONCAT__(x, y) x##y
+#	define DEBUG_LIB_CONCAT(x, y) DEBUG_LIB_CONCAT__(x, y)
+//	Traces time from this point to the end of enclosing scope as one event, name must be a constant
+#	define DEBUG_TRACE_SCOPE(name) ::DebugLib::TraceScope DEBUG_LIB_CONCAT(DEBUG_LIB_TRACE_SCOPE_VAR_NAME, __LINE__)(name)
+#else
+#	define DEBUG_TRACE_SCOPE(name) ((void)0)
+#endif /* DEBUG && DEBUG_LIB_TRACE */
+
 /* Debug message start macro set */
 
 // Allows to use preprocessor operator# in non function-like macros
 #define DEBUG_LIB_AS_C_STRING__(val) #val
 #define DEBUG_LIB_AS_C_STRING(val) DEBUG_LIB_AS_C_STRING__(val)
 
+// Branch hint of message checks : messages in hot code are expected to be suppressed
+#ifndef DEBUG_LIB_UNLIKELY
+#	if defined(__GNUC__)
+#		define DEBUG_LIB_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#	else
+#		define DEBUG_LIB_UNLIKELY(condition) (condition)
+#	endif
+#endif /* DEBUG_LIB_UNLIKELY */
+
+// Brackets of message body : a plain block laid out off the hot path by DEBUG_LIB_UNLIKELY and the cold commit of
+// the record. If DEBUG_LIB_COLD_LAMBDA is defined the body is a lambda that captures by copy and is called by a cold
+// function, so it does not take registers or stack of the enclosing function, but return, break and continue inside
+// it affect only the message and variables of the enclosing function can't be changed by it
+#ifndef DEBUG_LIB_COLD_BEGIN
+#	if defined(DEBUG_LIB_COLD_LAMBDA) && defined(__GNUC__) && __cplusplus >= 201103L
+namespace DebugLib
+{
+	/**
+	 *	@brief Calls message body out of line.
+	 *	Body is passed by value, so values it captures are copied only when the message is written.
+	 */
+	template < typename Body >
+	__attribute__((cold, noinline)) void CallColdBody(Body body)
+	{
+		body();
+	}
+}
+#		define DEBUG_LIB_COLD_BEGIN ::DebugLib::CallColdBody([=]() {
+#		define DEBUG_LIB_COLD_END });
+#	else
+#		define DEBUG_LIB_COLD_BEGIN {
+#		define DEBUG_LIB_COLD_END }
+#	endif
+#endif /* DEBUG_LIB_COLD_BEGIN */
+
 // Messages that starts with this macro have INFO level of importance
 // First line of message will be generated automatically:
 // "INFO::File_name:Line_number" 
 #ifndef DEBUG_INFO_MESSAGE
 
-#	if defined(DEBUG) && defined(DEBUG_LIB_THREAD_SAFETY)
-
-#		define DEBUG_INFO_MESSAGE \
-{ \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::Info ) \
-	{ \
-		::std::lock_guard<::std::mutex> DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME(::DebugLib::DEBUG_LIB_MUTEX_VAR_NAME); \
-		DEBUG_PRINT1("INFO::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__));
-
-#	elif defined(DEBUG) && !defined(DEBUG_LIB_THREAD_SAFETY)
+#	ifdef DEBUG
 
 #		define DEBUG_INFO_MESSAGE \
 { \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::Info ) \
-	{ \
-		DEBUG_PRINT1("INFO::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__));
+	if (DEBUG_LIB_UNLIKELY(DEBUG_LIB_INFO_ENABLED)) \
+	DEBUG_LIB_COLD_BEGIN \
+		DEBUG_LIB_MESSAGE_OPEN(::DebugLib::Level::Info, "INFO::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__))
 		
 #	else
 
@@ -262,22 +762,13 @@ namespace DebugLib
 // "WARNING::File_name:Line_number" 
 #ifndef DEBUG_WARNING_MESSAGE
 
-#	if defined(DEBUG) && defined(DEBUG_LIB_THREAD_SAFETY)
-
-#		define DEBUG_WARNING_MESSAGE \
-{ \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::Warning ) \
-	{ \
-		::std::lock_guard<::std::mutex> DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME(::DebugLib::DEBUG_LIB_MUTEX_VAR_NAME); \
-		DEBUG_PRINT1("WARNING::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__));
-
-#	elif defined(DEBUG) && !defined(DEBUG_LIB_THREAD_SAFETY)
+#	ifdef DEBUG
 
 #		define DEBUG_WARNING_MESSAGE \
 { \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::Warning ) \
-	{ \
-		DEBUG_PRINT1("WARNING::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__));
+	if (DEBUG_LIB_UNLIKELY(DEBUG_LIB_WARNING_ENABLED)) \
+	DEBUG_LIB_COLD_BEGIN \
+		DEBUG_LIB_MESSAGE_OPEN(::DebugLib::Level::Warning, "WARNING::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__))
 
 #	else
 
@@ -295,22 +786,13 @@ namespace DebugLib
 // "ERROR::File_name:Line_number" 
 #ifndef DEBUG_ERROR_MESSAGE
 
-#	if defined(DEBUG) && defined(DEBUG_LIB_THREAD_SAFETY)
-
-#		define DEBUG_ERROR_MESSAGE \
-{ \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::Error ) \
-	{ \
-		::std::lock_guard<::std::mutex> DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME(::DebugLib::DEBUG_LIB_MUTEX_VAR_NAME); \
-		DEBUG_PRINT1("ERROR::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__));
-
-#	elif defined(DEBUG) && !defined(DEBUG_LIB_THREAD_SAFETY)
+#	ifdef DEBUG
 
 #		define DEBUG_ERROR_MESSAGE \
 { \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::Error ) \
-	{ \
-		DEBUG_PRINT1("ERROR::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__));
+	if (DEBUG_LIB_UNLIKELY(DEBUG_LIB_ERROR_ENABLED)) \
+	DEBUG_LIB_COLD_BEGIN \
+		DEBUG_LIB_MESSAGE_OPEN(::DebugLib::Level::Error, "ERROR::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__))
 
 #	else
 
@@ -328,22 +810,14 @@ namespace DebugLib
 // All provided arguments are forwarded to DEBUG_PRINT(...)
 #ifndef DEBUG_NEW_MESSAGE
 
-#	if defined(DEBUG) && defined(DEBUG_LIB_THREAD_SAFETY)
+#	ifdef DEBUG
 
 #		define DEBUG_NEW_MESSAGE(...) \
 { \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::User ) \
-	{ \
-		::std::lock_guard<::std::mutex> DEBUG_LIB_LOG_LOCK_GUARG_VAR_NAME(::DebugLib::DEBUG_LIB_MUTEX_VAR_NAME); \
+	if (DEBUG_LIB_UNLIKELY(DEBUG_LIB_USER_ENABLED)) \
+	DEBUG_LIB_COLD_BEGIN \
+		DEBUG_LIB_MESSAGE_BEGIN(::DebugLib::Level::User, "") \
 		DEBUG_PRINT(__VA_ARGS__);
-
-#	elif defined(DEBUG) && !defined(DEBUG_LIB_THREAD_SAFETY)
-
-#		define DEBUG_NEW_MESSAGE(...) \
-{ \
-	if (::DebugLib::GetGlobalLogLevel() <= ::DebugLib::Level::User ) \
-	{ \
-		DEBUG_PRINT(__VA_ARGS__);	
 		
 #	else
 
@@ -356,12 +830,80 @@ namespace DebugLib
 
 #endif /* DEBUG_NEW_MESSAGE */
 
+/* Rate limited and sampled message start macro set */
+
+#ifdef DEBUG
+//	Call site state variable names macro def : to avoid name conflict
+#	ifndef DEBUG_LIB_SUPPRESSION_SITE_VAR_NAME
+#		define DEBUG_LIB_SUPPRESSION_SITE_VAR_NAME Debug_Lib_Suppression_Site__
+#	endif
+#	ifndef DEBUG_LIB_SUPPRESSION_STATE_VAR_NAME
+#		define DEBUG_LIB_SUPPRESSION_STATE_VAR_NAME Debug_Lib_Suppression_State__
+#	endif
+//	Minimal time in milliseconds between two summaries of suppressed messages
+#	ifndef DEBUG_LIB_SUPPRESSION_SUMMARY_PERIOD
+#		define DEBUG_LIB_SUPPRESSION_SUMMARY_PERIOD 1000
+#	endif
+//	Period in suppressed messages of limited messages of one thread after which the clock is read again
+#	ifndef DEBUG_LIB_SUPPRESSION_CHECK_PERIOD
+#		define DEBUG_LIB_SUPPRESSION_CHECK_PERIOD 64
+#	endif
+#	include "cRateLimit.hpp"
+//	Start of message that is written only if check passes : check may use call site state
+#	define DEBUG_LIB_SUPPRESSIBLE_MESSAGE(enabled, level, header, check) \
+{ \
+	static ::DebugLib::SuppressionSite DEBUG_LIB_SUPPRESSION_SITE_VAR_NAME(header); \
+	static thread_local ::DebugLib::SuppressionState DEBUG_LIB_SUPPRESSION_STATE_VAR_NAME; \
+	if (DEBUG_LIB_UNLIKELY((enabled) && (check))) \
+	DEBUG_LIB_COLD_BEGIN \
+		DEBUG_LIB_MESSAGE_OPEN(level, header)
+#	define DEBUG_LIB_SAMPLE_CHECK(period) \
+	::DebugLib::SampleMessage(DEBUG_LIB_SUPPRESSION_SITE_VAR_NAME, DEBUG_LIB_SUPPRESSION_STATE_VAR_NAME, (period))
+#	define DEBUG_LIB_LIMIT_CHECK(count, window) \
+	::DebugLib::LimitMessage(DEBUG_LIB_SUPPRESSION_SITE_VAR_NAME, DEBUG_LIB_SUPPRESSION_STATE_VAR_NAME, (count), (window))
+#else
+#	define DEBUG_LIB_SUPPRESSIBLE_MESSAGE(enabled, level, header, check) \
+{ \
+	while(false) \
+	{
+#endif /* DEBUG */
+
+// Messages that starts with these macros are written once per period messages of calling thread
+// First line of message is the same as of DEBUG_INFO_MESSAGE, DEBUG_WARNING_MESSAGE and DEBUG_ERROR_MESSAGE
+#ifndef DEBUG_INFO_MESSAGE_SAMPLED
+#	define DEBUG_INFO_MESSAGE_SAMPLED(period) DEBUG_LIB_SUPPRESSIBLE_MESSAGE(DEBUG_LIB_INFO_ENABLED, ::DebugLib::Level::Info, \
+		"INFO::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__), DEBUG_LIB_SAMPLE_CHECK(period))
+#endif
+#ifndef DEBUG_WARNING_MESSAGE_SAMPLED
+#	define DEBUG_WARNING_MESSAGE_SAMPLED(period) DEBUG_LIB_SUPPRESSIBLE_MESSAGE(DEBUG_LIB_WARNING_ENABLED, ::DebugLib::Level::Warning, \
+		"WARNING::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__), DEBUG_LIB_SAMPLE_CHECK(period))
+#endif
+#ifndef DEBUG_ERROR_MESSAGE_SAMPLED
+#	define DEBUG_ERROR_MESSAGE_SAMPLED(period) DEBUG_LIB_SUPPRESSIBLE_MESSAGE(DEBUG_LIB_ERROR_ENABLED, ::DebugLib::Level::Error, \
+		"ERROR::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__), DEBUG_LIB_SAMPLE_CHECK(period))
+#endif
+
+// Messages that starts with these macros are written at most count times per window milliseconds by calling thread
+// First line of message is the same as of DEBUG_INFO_MESSAGE, DEBUG_WARNING_MESSAGE and DEBUG_ERROR_MESSAGE
+#ifndef DEBUG_INFO_MESSAGE_LIMITED
+#	define DEBUG_INFO_MESSAGE_LIMITED(count, window) DEBUG_LIB_SUPPRESSIBLE_MESSAGE(DEBUG_LIB_INFO_ENABLED, ::DebugLib::Level::Info, \
+		"INFO::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__), DEBUG_LIB_LIMIT_CHECK(count, window))
+#endif
+#ifndef DEBUG_WARNING_MESSAGE_LIMITED
+#	define DEBUG_WARNING_MESSAGE_LIMITED(count, window) DEBUG_LIB_SUPPRESSIBLE_MESSAGE(DEBUG_LIB_WARNING_ENABLED, ::DebugLib::Level::Warning, \
+		"WARNING::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__), DEBUG_LIB_LIMIT_CHECK(count, window))
+#endif
+#ifndef DEBUG_ERROR_MESSAGE_LIMITED
+#	define DEBUG_ERROR_MESSAGE_LIMITED(count, window) DEBUG_LIB_SUPPRESSIBLE_MESSAGE(DEBUG_LIB_ERROR_ENABLED, ::DebugLib::Level::Error, \
+		"ERROR::" __FILE__ ":" DEBUG_LIB_AS_C_STRING(__LINE__), DEBUG_LIB_LIMIT_CHECK(count, window))
+#endif
+
 /* Debug message end macro set */
 
 // End message and flush
 #ifndef DEBUG_END_MESSAGE
 #	ifdef DEBUG
-#		define DEBUG_END_MESSAGE DEBUG_OUT << DEBUG_LIB_FLUSH; } }
+#		define DEBUG_END_MESSAGE DEBUG_LIB_MESSAGE_CLOSE DEBUG_LIB_COLD_END }
 #	else
 #		define DEBUG_END_MESSAGE } }
 #	endif
@@ -371,8 +913,8 @@ namespace DebugLib
 #ifndef DEBUG_END_MESSAGE_AND_EVAL
 #	ifdef DEBUG
 #		define DEBUG_END_MESSAGE_AND_EVAL(expression) \
-			DEBUG_OUT << DEBUG_LIB_FLUSH; \
-		}\
+			DEBUG_LIB_MESSAGE_CLOSE \
+		DEBUG_LIB_COLD_END \
 	expression \
  }
 #	else
@@ -387,7 +929,7 @@ namespace DebugLib
 #ifndef DEBUG_END_MESSAGE_AND_EXIT
 #	ifdef DEBUG
 #		define DEBUG_END_MESSAGE_AND_EXIT(exitcode) \
-		DEBUG_OUT << DEBUG_LIB_FLUSH; } ::std::exit((exitcode)); }
+		DEBUG_LIB_MESSAGE_CLOSE DEBUG_LIB_COLD_END ::std::exit((exitcode)); }
 #	else
 #		define DEBUG_END_MESSAGE_AND_EXIT(exitcode) \
 		} ::std::exit((exitcode)); }
@@ -398,8 +940,8 @@ namespace DebugLib
 #ifndef DEBUG_END_MESSAGE_EVAL_AND_EXIT
 #	ifdef DEBUG
 #		define DEBUG_END_MESSAGE_EVAL_AND_EXIT(exitcode, expression) \
-			DEBUG_OUT << DEBUG_LIB_FLUSH; \
-		} \
+			DEBUG_LIB_MESSAGE_CLOSE \
+		DEBUG_LIB_COLD_END \
 	expression \
 	::std::exit((exitcode));\
  }
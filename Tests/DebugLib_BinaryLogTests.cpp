@@ -0,0 +1,174 @@
+#include "DebugLib_BinaryLogTests.hpp"
+
+// Value without binary tag : stored as text formatted on the calling thread
+struct Point
+{
+	int x;
+	int y;
+};
+
+std::ostream& operator<<(std::ostream& out, const Point& point)
+{
+	return out << '(' << point.x << ';' << point.y << ')';
+}
+
+// Frames written to DEBUG_OUT by all messages of this test and text that decoder must produce for them
+static std::string binaryLog;
+static std::ostringstream expectedText;
+
+// Runs write with DEBUG_OUT redirected to binaryLog
+static void capture(void (*write)())
+{
+	std::stringbuf frames;
+	std::streambuf* const previous = DEBUG_OUT.rdbuf(&frames);
+	write();
+	DEBUG_OUT.rdbuf(previous);
+	binaryLog += frames.str();
+}
+
+static bool decodesTo(const std::string& log, const std::string& text)
+{
+	std::ostringstream out;
+	return ::DebugLib::DecodeBinaryLog(out, log.data(), log.size()) == log.size() && out.str() == text;
+}
+
+// Offset of the first malformed frame of log
+static std::size_t decodedSize(const std::string& log)
+{
+	std::ostringstream out;
+	return ::DebugLib::DecodeBinaryLog(out, log.data(), log.size());
+}
+
+template < typename T >
+static void appendRaw(std::string& log, T value)
+{
+	log.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void writeValues()
+{
+	const Point point = { 1, -2 };
+	DEBUG_NEW_MESSAGE("#Binary values")
+		DEBUG_PRINT(true, ' ', 'c', ' ', (short)-3, ' ', 40000u, ' ', -5000000000ll, ' ', 18446744073709551615ull);
+		DEBUG_PRINT(0.5f, ' ', 0.125, ' ', "text ", std::string("string"), ' ', point);
+	DEBUG_END_MESSAGE
+	expectedText << "#Binary values\n" << true << ' ' << 'c' << ' ' << (short)-3 << ' ' << 40000u << ' ' << -5000000000ll << ' '
+		<< 18446744073709551615ull << '\n' << 0.5f << ' ' << 0.125 << ' ' << "text " << std::string("string") << ' ' << point << '\n';
+}
+
+static void writeKeyValues()
+{
+	DEBUG_NEW_MESSAGE("#Binary key values")
+		DEBUG_KV("text", "quote \" and \\", "count", 3, "ratio", 0.25, "flag", false);
+	DEBUG_END_MESSAGE
+	expectedText << "#Binary key values\n";
+	::DebugLib::WriteKeyValues(expectedText, "text", "quote \" and \\", "count", 3, "ratio", 0.25, "flag", false) << '\n';
+}
+
+static void writeManipulators()
+{
+	DEBUG_NEW_MESSAGE("#Binary manipulators")
+		DEBUG_PRINT(std::hex, 255, std::endl, std::flush);
+	DEBUG_END_MESSAGE
+	expectedText << "#Binary manipulators\n255\n";
+}
+
+// Site of message is defined before its first message only
+static void writeSites()
+{
+	for (int i = 0; i < 2; ++i)
+	{
+		const int infoLine = __LINE__ + 1;
+		DEBUG_INFO_MESSAGE
+			DEBUG_PRINT("\tinfo ", i);
+		DEBUG_END_MESSAGE
+		const int warningLine = __LINE__ + 1;
+		DEBUG_WARNING_MESSAGE
+			DEBUG_PRINT("\twarning ", i);
+		DEBUG_END_MESSAGE
+		expectedText << "INFO::" << __FILE__ << ':' << infoLine << "\n\tinfo " << i << '\n';
+		expectedText << "WARNING::" << __FILE__ << ':' << warningLine << "\n\twarning " << i << '\n';
+	}
+}
+
+AUTO_TEST_CASE(BinaryRoundTripTests, 5, std::string)
+	AUTO_TEST(1,
+	{
+		capture(writeValues);
+		TEST_PASSED(!binaryLog.empty() && binaryLog[0] == ::DebugLib::SessionFrame);
+		TEST_PASSED(decodesTo(binaryLog, expectedText.str()));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		capture(writeKeyValues);
+		TEST_PASSED(decodesTo(binaryLog, expectedText.str()));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		capture(writeManipulators);
+		TEST_PASSED(decodesTo(binaryLog, expectedText.str()));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		capture(writeSites);
+		TEST_PASSED(decodesTo(binaryLog, expectedText.str()));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(5,
+	{
+		// Every process run appends a new session that defines its sites again
+		TEST_PASSED(decodesTo(binaryLog + binaryLog, expectedText.str() + expectedText.str()));
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(MalformedBinaryLogTests, 4, std::string)
+	AUTO_TEST(1,
+	{
+		// Frame cut at any byte is reported at its start
+		AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests) = binaryLog.substr(0, binaryLog.size() - 1);
+		const std::size_t decoded = decodedSize(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests));
+		TEST_PASSED(decoded < AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests).size());
+		TEST_PASSED(binaryLog[decoded] == ::DebugLib::MessageFrame);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests) = binaryLog + "X";
+		TEST_PASSED(decodedSize(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests)) == binaryLog.size());
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests).assign(1, ::DebugLib::SessionFrame);
+		appendRaw(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests), (std::uint32_t)(DEBUG_LIB_BINARY_VERSION + 1));
+		TEST_PASSED(decodedSize(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests)) == 0);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Sites are defined in order, so a site past the next one and huge lengths are rejected
+		AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests).assign(1, ::DebugLib::SiteFrame);
+		appendRaw(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests), (std::uint32_t)0xFFFFFFFFu);
+		appendRaw(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests), (std::uint32_t)0);
+		TEST_PASSED(decodedSize(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests)) == 0);
+		AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests).assign(1, ::DebugLib::SiteFrame);
+		appendRaw(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests), (std::uint32_t)0);
+		appendRaw(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests), (std::uint32_t)0xFFFFFFFFu);
+		TEST_PASSED(decodedSize(AUTO_TEST_GET_FIXTURE(MalformedBinaryLogTests)) == 0);
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(BinaryRoundTripTests,		tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(MalformedBinaryLogTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
@@ -0,0 +1,13 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+/// CodeSnippets
+#ifndef DEBUG_LIB_TEST_BINARY
+#	define DEBUG_LIB_TEST_BINARY
+#endif
+#include <DebugLib/mDebugLib.hpp>
+#include "DebugLib_TestMacros.hpp"
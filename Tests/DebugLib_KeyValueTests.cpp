@@ -0,0 +1,101 @@
+#include "DebugLib_KeyValueTests.hpp"
+
+// Value without JSON type : formatted with operator<< and written as a string
+struct Point
+{
+	int x;
+	int y;
+};
+
+std::ostream& operator<<(std::ostream& out, const Point& point)
+{
+	return out << "(\"" << point.x << "\";" << point.y << ')';
+}
+
+template < typename... Fields >
+static std::string json(const Fields&... fields)
+{
+	std::ostringstream out;
+	::DebugLib::WriteKeyValues(out, fields...);
+	return out.str();
+}
+
+static std::string withString(const std::string& value)
+{
+	return json("k", value);
+}
+
+AUTO_TEST_CASE(KeyValueTypesTests, 3, int)
+	AUTO_TEST(1,
+	{
+		TEST_PASSED(json() == "{}");
+		TEST_PASSED(json("i", -12, "u", 40000u, "b", true, "f", false) == "{\"i\":-12,\"u\":40000,\"b\":true,\"f\":false}");
+		TEST_PASSED(json("min", std::numeric_limits<long long>::min()) == "{\"min\":-9223372036854775808}");
+		TEST_PASSED(json("max", std::numeric_limits<unsigned long long>::max()) == "{\"max\":18446744073709551615}");
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Shortest form that is read back to the same value
+		TEST_PASSED(json("f", 0.1f, "d", 0.1, "e", 1e300) == "{\"f\":0.1,\"d\":0.1,\"e\":1e+300}");
+		TEST_PASSED(json("third", 1.0 / 3) == "{\"third\":0.33333333333333331}");
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		const char* none = nullptr;
+		TEST_PASSED(json("c", 'c', "s", "text", "n", none, "p", nullptr) == "{\"c\":\"c\",\"s\":\"text\",\"n\":null,\"p\":null}");
+		TEST_PASSED(json("ptr", reinterpret_cast<const void*>(0x1F)) == "{\"ptr\":\"0x1f\"}");
+		TEST_PASSED(json("point", Point{ 1, -2 }) == "{\"point\":\"(\\\"1\\\";-2)\"}");
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(KeyValueEscapingTests, 4, int)
+	AUTO_TEST(1,
+	{
+		TEST_PASSED(withString("say \"hi\"") == "{\"k\":\"say \\\"hi\\\"\"}");
+		TEST_PASSED(withString("C:\\dir\\") == "{\"k\":\"C:\\\\dir\\\\\"}");
+		TEST_PASSED(json("quoted \"key\"", 1) == "{\"quoted \\\"key\\\"\":1}");
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Control characters are escaped, other bytes of UTF-8 text are written as is
+		TEST_PASSED(withString("a\nb\rc\td") == "{\"k\":\"a\\nb\\rc\\td\"}");
+		TEST_PASSED(withString(std::string("\x01\x1f\0", 3)) == "{\"k\":\"\\u0001\\u001f\\u0000\"}");
+		TEST_PASSED(withString("\x7f\xc3\xa9") == "{\"k\":\"\x7f\xc3\xa9\"}");
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		// JSON has no infinities and NaN
+		TEST_PASSED(json("nan", std::numeric_limits<double>::quiet_NaN()) == "{\"nan\":null}");
+		TEST_PASSED(json("inf", std::numeric_limits<float>::infinity()) == "{\"inf\":null}");
+		TEST_PASSED(json("-inf", -std::numeric_limits<long double>::infinity(), "x", 1) == "{\"-inf\":null,\"x\":1}");
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Field that does not fit is discarded as a whole : fields after it are still written
+		const std::string object = json("a", 1, "long", std::string(DEBUG_LIB_KV_SIZE, 'x'), "b", 2);
+		TEST_PASSED(object == "{\"a\":1,\"b\":2}");
+		const std::string escaped = withString(std::string(DEBUG_LIB_KV_SIZE / 2, '"'));
+		TEST_PASSED(escaped == "{}");
+		// Object of the largest field that fits has DEBUG_LIB_KV_SIZE characters
+		const std::string fitting = withString(std::string(DEBUG_LIB_KV_SIZE - 8, 'x'));
+		TEST_PASSED(fitting.size() == DEBUG_LIB_KV_SIZE);
+		TEST_PASSED(withString(std::string(DEBUG_LIB_KV_SIZE - 7, 'x')) == "{}");
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(KeyValueTypesTests,		tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(KeyValueEscapingTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
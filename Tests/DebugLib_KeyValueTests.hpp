@@ -0,0 +1,11 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+#include <DebugLib/cKeyValue.hpp>
+#include "DebugLib_TestMacros.hpp"
@@ -0,0 +1,172 @@
+#include "DebugLib_LogIndexTests.hpp"
+
+// Content of index file and result of its reading
+struct IndexFixture
+{
+	std::string index;
+	std::vector<::DebugLib::IndexEntry> entries;
+	std::vector<std::string> files;
+
+	bool read()
+	{
+		entries.clear();
+		files.clear();
+		return ::DebugLib::ReadIndex(index.data(), index.size(), entries, files);
+	}
+
+	template < typename T >
+	void put(T value)
+	{
+		index.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void session(std::uint32_t version = DEBUG_LIB_INDEX_VERSION)
+	{
+		index += ::DebugLib::IndexSessionFrame;
+		put(version);
+	}
+
+	void file(std::uint32_t id, const char* name)
+	{
+		index += ::DebugLib::IndexFileFrame;
+		put(id);
+		put(static_cast<std::uint32_t>(std::strlen(name)));
+		index += name;
+	}
+
+	void entry(std::uint64_t offset, std::uint32_t length, std::uint8_t level, std::uint32_t file)
+	{
+		index += ::DebugLib::IndexEntryFrame;
+		put(offset);
+		put(length);
+		put(level);
+		put(file);
+	}
+
+	bool hasEntry(std::size_t i, std::uint64_t offset, std::uint32_t length, std::uint8_t level, std::uint32_t file) const
+	{
+		return i < entries.size() && entries[i].offset == offset && entries[i].length == length &&
+			entries[i].level == level && entries[i].file == file;
+	}
+};
+
+static bool headerFile(const char* header, const char* expected)
+{
+	std::size_t length = 0;
+	const char* name = ::DebugLib::GetHeaderFile(header, length);
+	return expected ? name && std::string(name, length) == expected : !name;
+}
+
+AUTO_TEST_CASE(ReadIndexTests, 4, IndexFixture)
+	AUTO_TEST(1,
+	{
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).read());
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).entries.empty());
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).files.empty());
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).session();
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).file(0, "a.cpp");
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).entry(0, 20, 0, 0);
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).file(1, "b.cpp");
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).entry(20, 30, 1, 1);
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).entry(50, 10, 3, DEBUG_LIB_INDEX_NO_FILE);
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).entry(60, 20, 2, 0);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).read());
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).files.size() == 2);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).files[0] == "a.cpp" && AUTO_TEST_GET_FIXTURE(ReadIndexTests).files[1] == "b.cpp");
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).entries.size() == 4);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).hasEntry(0, 0, 20, 0, 0));
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).hasEntry(1, 20, 30, 1, 1));
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).hasEntry(2, 50, 10, 3, DEBUG_LIB_INDEX_NO_FILE));
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).hasEntry(3, 60, 20, 2, 0));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		// Second process run gives its own identifiers : equal names are merged, identifiers of the first run are forgotten
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).session();
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).entry(80, 10, 0, 1);
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).file(0, "b.cpp");
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).file(1, "c.cpp");
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).entry(90, 10, 1, 1);
+		AUTO_TEST_GET_FIXTURE(ReadIndexTests).entry(100, 10, 2, 0);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).read());
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).files.size() == 3);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).files[1] == "b.cpp" && AUTO_TEST_GET_FIXTURE(ReadIndexTests).files[2] == "c.cpp");
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).entries.size() == 7);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).hasEntry(4, 80, 10, 0, DEBUG_LIB_INDEX_NO_FILE));
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).hasEntry(5, 90, 10, 1, 2));
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ReadIndexTests).hasEntry(6, 100, 10, 2, 1));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		TEST_PASSED(headerFile("INFO::dir/file.cpp:12", "dir/file.cpp"));
+		TEST_PASSED(headerFile("WARNING::C:\\dir\\file.cpp:7", "C:\\dir\\file.cpp"));
+		TEST_PASSED(headerFile("#User header", nullptr));
+		TEST_PASSED(headerFile("INFO::no line", nullptr));
+		TEST_PASSED(headerFile(nullptr, nullptr));
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(MalformedIndexTests, 4, IndexFixture)
+	AUTO_TEST(1,
+	{
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).session(DEBUG_LIB_INDEX_VERSION + 1);
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(MalformedIndexTests).read());
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Entries read before the error are kept
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index.clear();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).session();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).entry(0, 10, 0, DEBUG_LIB_INDEX_NO_FILE);
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).entry(10, 10, 0, DEBUG_LIB_INDEX_NO_FILE);
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index.pop_back();
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(MalformedIndexTests).read());
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(MalformedIndexTests).entries.size() == 1);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index.clear();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).session();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index += 'X';
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(MalformedIndexTests).read());
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index.assign(1, ::DebugLib::IndexFileFrame);
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).put(static_cast<std::uint32_t>(0));
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).put(static_cast<std::uint32_t>(100));
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index += "short.cpp";
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(MalformedIndexTests).read());
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Files are defined in order, so identifiers past the next one are rejected without allocation
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index.clear();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).session();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).file(DEBUG_LIB_INDEX_NO_FILE, "a.cpp");
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(MalformedIndexTests).read());
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).index.clear();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).session();
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).file(0, "a.cpp");
+		AUTO_TEST_GET_FIXTURE(MalformedIndexTests).file(2, "b.cpp");
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(MalformedIndexTests).read());
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(ReadIndexTests,		tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(MalformedIndexTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
@@ -0,0 +1,11 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+#include <DebugLib/cLogIndex.hpp>
+#include "DebugLib_TestMacros.hpp"
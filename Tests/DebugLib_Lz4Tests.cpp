@@ -0,0 +1,211 @@
+#include "DebugLib_Lz4Tests.hpp"
+
+static std::uint32_t get32(const std::string& data, std::size_t offset)
+{
+	return static_cast<std::uint32_t>(static_cast<unsigned char>(data[offset])) |
+		static_cast<std::uint32_t>(static_cast<unsigned char>(data[offset + 1])) << 8 |
+		static_cast<std::uint32_t>(static_cast<unsigned char>(data[offset + 2])) << 16 |
+		static_cast<std::uint32_t>(static_cast<unsigned char>(data[offset + 3])) << 24;
+}
+
+static bool getLength(const std::string& block, std::size_t& pos, std::size_t& length)
+{
+	unsigned char byte = 255;
+	while (byte == 255)
+	{
+		if (pos >= block.size())
+			return false;
+		byte = static_cast<unsigned char>(block[pos++]);
+		length += byte;
+	}
+	return true;
+}
+
+// Reference decoder of one block : also checks limits of the format on placement of the last match
+static bool decodeBlock(const std::string& block, std::string& out)
+{
+	const std::size_t start = out.size();
+	std::size_t pos = 0;
+	while (pos < block.size())
+	{
+		const unsigned char token = static_cast<unsigned char>(block[pos++]);
+		std::size_t literals = token >> 4;
+		if (literals == 15 && !getLength(block, pos, literals))
+			return false;
+		if (literals > block.size() - pos)
+			return false;
+		out.append(block, pos, literals);
+		pos += literals;
+		if (pos == block.size())
+			return true;
+		if (block.size() - pos < 2 || out.size() - start + 12 > DEBUG_LIB_LZ4_BLOCK_SIZE)
+			return false;
+		const std::size_t offset = static_cast<unsigned char>(block[pos]) | static_cast<std::size_t>(static_cast<unsigned char>(block[pos + 1])) << 8;
+		pos += 2;
+		std::size_t length = token & 15;
+		if (length == 15 && !getLength(block, pos, length))
+			return false;
+		length += 4;
+		if (!offset || offset > out.size() - start)
+			return false;
+		for (std::size_t i = 0; i < length; ++i)
+			out += out[out.size() - offset];
+	}
+	return false;
+}
+
+// Reference decoder of the frame written by CompressStream
+static bool decodeFrame(const std::string& frame, std::string& out)
+{
+	out.clear();
+	if (frame.size() < 7 || get32(frame, 0) != 0x184D2204u)
+		return false;
+	const unsigned char* descriptor = reinterpret_cast<const unsigned char*>(frame.data()) + 4;
+	if (static_cast<unsigned char>(frame[6]) != static_cast<unsigned char>(::DebugLib::Lz4::ShortHash(descriptor, 2) >> 8))
+		return false;
+	std::size_t pos = 7;
+	for (;;)
+	{
+		if (frame.size() - pos < 4)
+			return false;
+		const std::uint32_t size = get32(frame, pos);
+		pos += 4;
+		if (!size)
+			return pos == frame.size();
+		const std::size_t length = size & 0x7FFFFFFFu;
+		if (length > DEBUG_LIB_LZ4_BLOCK_SIZE || length > frame.size() - pos)
+			return false;
+		const std::size_t before = out.size();
+		if (size & 0x80000000u)
+			out.append(frame, pos, length);
+		else if (!decodeBlock(frame.substr(pos, length), out))
+			return false;
+		if (out.size() - before > DEBUG_LIB_LZ4_BLOCK_SIZE)
+			return false;
+		pos += length;
+	}
+}
+
+static std::string compress(const std::string& data)
+{
+	std::istringstream input(data);
+	std::ostringstream output;
+	::DebugLib::Lz4::CompressStream(input, output);
+	return output.str();
+}
+
+static bool roundTrip(const std::string& data)
+{
+	std::string decoded;
+	return decodeFrame(compress(data), decoded) && decoded == data;
+}
+
+static bool blockRoundTrip(const std::string& data)
+{
+	std::string packed(::DebugLib::Lz4::BlockBound(data.size()), '\0');
+	packed.resize(::DebugLib::Lz4::CompressBlock(data.data(), data.size(), &packed[0]));
+	std::string decoded;
+	return decodeBlock(packed, decoded) && decoded == data;
+}
+
+// Lines of log : compressible data
+static std::string logText(std::size_t size)
+{
+	std::ostringstream out;
+	for (std::size_t line = 0; out.tellp() < static_cast<std::streamoff>(size); ++line)
+		out << "INFO::Tests/DebugLib_Lz4Tests.cpp:" << line % 97 << " Message number " << line << '\n';
+	return out.str().substr(0, size);
+}
+
+// Pseudo-random bytes : data that does not shrink
+static std::string noise(std::size_t size)
+{
+	std::string data(size, '\0');
+	std::uint32_t state = 2463534242u;
+	for (auto& byte : data)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		byte = static_cast<char>(state >> 24);
+	}
+	return data;
+}
+
+AUTO_TEST_CASE(Lz4FrameTests, 3, int)
+	AUTO_TEST(1,
+	{
+		// Magic, version 01 with independent blocks, 64 KiB blocks and checksum of descriptor
+		const std::string frame = compress(std::string());
+		TEST_PASSED(frame == std::string("\x04\x22\x4D\x18\x60\x40\x82\0\0\0\0", 11));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Data that does not shrink is stored in blocks of 64 KiB with the uncompressed flag
+		const std::string frame = compress(noise(DEBUG_LIB_LZ4_BLOCK_SIZE + 10));
+		TEST_PASSED(frame.size() == 7 + 4 + DEBUG_LIB_LZ4_BLOCK_SIZE + 4 + 10 + 4);
+		TEST_PASSED(get32(frame, 7) == (DEBUG_LIB_LZ4_BLOCK_SIZE | 0x80000000u));
+		TEST_PASSED(get32(frame, 7 + 4 + DEBUG_LIB_LZ4_BLOCK_SIZE) == (10 | 0x80000000u));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		// Data of log is packed to compressed blocks
+		const std::string data = logText(3 * DEBUG_LIB_LZ4_BLOCK_SIZE);
+		const std::string frame = compress(data);
+		TEST_PASSED(frame.size() < data.size() / 2);
+		TEST_PASSED(!(get32(frame, 7) & 0x80000000u));
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(Lz4RoundTripTests, 4, int)
+	AUTO_TEST(1,
+	{
+		// Sizes around the limits of the format : no match may start in the last 12 bytes
+		TEST_PASSED(roundTrip(std::string()));
+		TEST_PASSED(roundTrip("a"));
+		TEST_PASSED(roundTrip(std::string(12, 'a')));
+		TEST_PASSED(roundTrip(std::string(13, 'a')));
+		TEST_PASSED(roundTrip(logText(12)));
+		TEST_PASSED(roundTrip(logText(13)));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		for (std::size_t size = 0; size <= 64; ++size)
+		{
+			TEST_PASSED(blockRoundTrip(std::string(size, 'x')));
+			TEST_PASSED(blockRoundTrip(logText(size)));
+			TEST_PASSED(blockRoundTrip(noise(size)));
+		}
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		// Long literal runs and long matches use extra length bytes
+		TEST_PASSED(roundTrip(noise(1000) + std::string(1000, 'z') + noise(300)));
+		TEST_PASSED(roundTrip(std::string(DEBUG_LIB_LZ4_BLOCK_SIZE, '\0')));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Inputs of several blocks : each block is independent
+		TEST_PASSED(roundTrip(logText(DEBUG_LIB_LZ4_BLOCK_SIZE + 1)));
+		TEST_PASSED(roundTrip(logText(5 * DEBUG_LIB_LZ4_BLOCK_SIZE + 123)));
+		TEST_PASSED(roundTrip(noise(2 * DEBUG_LIB_LZ4_BLOCK_SIZE + 7)));
+		TEST_PASSED(roundTrip(logText(DEBUG_LIB_LZ4_BLOCK_SIZE) + noise(DEBUG_LIB_LZ4_BLOCK_SIZE) + logText(100)));
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(Lz4FrameTests,		tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(Lz4RoundTripTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
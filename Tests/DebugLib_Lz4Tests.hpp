@@ -0,0 +1,10 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+#include <DebugLib/cLz4.hpp>
+#include "DebugLib_TestMacros.hpp"
@@ -0,0 +1,128 @@
+#include "DebugLib_MetricsTests.hpp"
+#define MAX_VALUE (std::numeric_limits<std::uint64_t>::max())
+
+// DEBUG_LIB_METRICS defines DEBUG_LIB_THREAD_SAFETY : LOG takes this mutex
+std::mutex DebugLib::Debug_Lib_Logger_Singletone_Mutex__;
+
+// Bucket counts of one histogram as summed by the reporter
+struct HistogramFixture
+{
+	HistogramFixture() : buckets(), count(0) {}
+
+	void add(std::uint64_t value, std::uint64_t times)
+	{
+		buckets[::DebugLib::HistogramBucket(value)] += times;
+		count += times;
+	}
+
+	std::uint64_t percentile(unsigned percent) const
+	{
+		return ::DebugLib::HistogramPercentile(buckets, count, percent);
+	}
+
+	void clear()
+	{
+		*this = HistogramFixture();
+	}
+
+	std::uint64_t buckets[DEBUG_LIB_HISTOGRAM_SLOTS - 1];
+	std::uint64_t count;
+};
+
+// Every value is not greater than the bound of its bucket and greater than the bound of the previous bucket
+static bool boundsHoldValues()
+{
+	for (unsigned bucket = 0; bucket < DEBUG_LIB_HISTOGRAM_SLOTS - 1; ++bucket)
+	{
+		const std::uint64_t bound = ::DebugLib::HistogramBound(bucket);
+		if (::DebugLib::HistogramBucket(bound) != bucket || (bucket && ::DebugLib::HistogramBucket(bound / 2 + 1) != bucket))
+			return false;
+	}
+	return true;
+}
+
+// Slots of shard of calling thread taken by the histogram
+static std::uint64_t shardSlot(std::uint32_t id, unsigned slot)
+{
+	return ::DebugLib::GetMetricShard().slots[id + slot].load();
+}
+
+AUTO_TEST_CASE(HistogramBucketTests, 2, int)
+	AUTO_TEST(1,
+	{
+		TEST_PASSED(::DebugLib::HistogramBucket(0) == 0 && ::DebugLib::HistogramBucket(1) == 1);
+		TEST_PASSED(::DebugLib::HistogramBucket(2) == 2 && ::DebugLib::HistogramBucket(3) == 2 && ::DebugLib::HistogramBucket(4) == 3);
+		TEST_PASSED(::DebugLib::HistogramBucket(1023) == 10 && ::DebugLib::HistogramBucket(1024) == 11);
+		TEST_PASSED(::DebugLib::HistogramBucket(MAX_VALUE) == 64);
+		TEST_PASSED(::DebugLib::HistogramBound(0) == 0 && ::DebugLib::HistogramBound(10) == 1023);
+		TEST_PASSED(::DebugLib::HistogramBound(64) == MAX_VALUE);
+		TEST_PASSED(boundsHoldValues());
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Values recorded by the call site go to the shard of calling thread
+		const std::uint32_t id = ::DebugLib::RegisterMetric("test_histogram", ::DebugLib::MetricKind::Histogram);
+		TEST_PASSED(id == ::DebugLib::RegisterMetric("test_histogram", ::DebugLib::MetricKind::Histogram));
+		::DebugLib::RecordHistogram(id, 0);
+		::DebugLib::RecordHistogram(id, 5);
+		::DebugLib::RecordHistogram(id, 6);
+		DEBUG_HISTOGRAM_RECORD("test_histogram", 1000);
+		TEST_PASSED(shardSlot(id, 0) == 1 && shardSlot(id, 3) == 2 && shardSlot(id, 10) == 1);
+		TEST_PASSED(shardSlot(id, 1) == 0 && shardSlot(id, 11) == 0);
+		TEST_PASSED(shardSlot(id, DEBUG_LIB_HISTOGRAM_SLOTS - 1) == 1011);
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(HistogramPercentileTests, 4, HistogramFixture)
+	AUTO_TEST(1,
+	{
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(50) == 0);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(100) == 0);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Values 1 to 100 : value 50 is in bucket of 32 to 63, values 90 and 99 are in bucket of 64 to 127
+		for (std::uint64_t value = 1; value <= 100; ++value)
+			AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).add(value, 1);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(50) == 63);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(90) == 127);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(99) == 127);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(100) == 127);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		// Percentile in the bucket of zero is zero
+		AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).clear();
+		AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).add(0, 60);
+		AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).add(1000, 40);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(50) == 0);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(60) == 0);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(61) == 1023);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(100) == 1023);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Rare largest values change only the maximum
+		AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).clear();
+		AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).add(3, 1000);
+		AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).add(MAX_VALUE, 1);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(99) == 3);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(HistogramPercentileTests).percentile(100) == MAX_VALUE);
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(HistogramBucketTests,		tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(HistogramPercentileTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
@@ -0,0 +1,12 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+/// CodeSnippets
+#ifndef DEBUG_LIB_TEST_METRICS
+#	define DEBUG_LIB_TEST_METRICS
+#endif
+#include <DebugLib/mDebugLib.hpp>
+#include "DebugLib_TestMacros.hpp"
@@ -0,0 +1,193 @@
+#include "DebugLib_MpscQueueTests.hpp"
+#define PRODUCER_COUNT 4
+#define PRODUCER_WORK_SIZE ((std::size_t)1 << 16)
+
+typedef ::DebugLib::MpscQueue<std::size_t, 4> SmallQueue;
+
+struct ProducedItem
+{
+	std::size_t producer;
+	std::size_t sequence;
+};
+
+typedef ::DebugLib::MpscQueue<ProducedItem, 64> SharedQueue;
+
+static bool push(SmallQueue& queue, std::size_t value)
+{
+	return queue.try_push([value](std::size_t& slot) { slot = value; });
+}
+
+static bool pop(SmallQueue& queue, std::size_t& value)
+{
+	return queue.try_pop([&value](std::size_t& slot) { value = slot; });
+}
+
+// Values from first to last are pushed to queue and then popped in the same order
+static bool pushThenPop(SmallQueue& queue, std::size_t first, std::size_t last)
+{
+	std::size_t value = 0;
+	for (std::size_t i = first; i < last; ++i)
+		if (!push(queue, i))
+			return false;
+	for (std::size_t i = first; i < last; ++i)
+		if (!pop(queue, value) || value != i)
+			return false;
+	return queue.empty();
+}
+
+static void producer(SharedQueue& queue, std::size_t id)
+{
+	for (std::size_t i = 0; i < PRODUCER_WORK_SIZE; ++i)
+		while (!queue.try_push([id, i](ProducedItem& slot) { slot.producer = id; slot.sequence = i; }))
+			std::this_thread::yield();
+}
+
+// Pops items until all producers are done and the queue is empty
+// Items of every producer must be taken in order they were pushed
+static std::size_t consumer(SharedQueue& queue, const std::atomic<int>& running)
+{
+	std::array<std::size_t, PRODUCER_COUNT> next = {};
+	std::size_t count = 0;
+	bool ordered = true;
+	for (;;)
+	{
+		const bool done = !running.load();
+		ProducedItem item = {};
+		if (!queue.try_pop([&item](ProducedItem& slot) { item = slot; }))
+		{
+			if (done)
+				break;
+			std::this_thread::yield();
+			continue;
+		}
+		ordered = ordered && item.producer < PRODUCER_COUNT && item.sequence >= next[item.producer];
+		if (ordered)
+			next[item.producer] = item.sequence + 1;
+		++count;
+	}
+	return ordered ? count : 0;
+}
+
+// Runs producers and consumers, returns count of items taken in order by all consumers
+static std::size_t produceAndConsume(SharedQueue& queue, std::size_t consumers)
+{
+	std::atomic<int> running(PRODUCER_COUNT);
+	std::vector< std::future<void> > producers;
+	std::vector< std::future<std::size_t> > results;
+	for (std::size_t i = 0; i < consumers; ++i)
+		results.push_back(std::async(std::launch::async, consumer, std::ref(queue), std::cref(running)));
+	for (std::size_t i = 0; i < PRODUCER_COUNT; ++i)
+		producers.push_back(std::async(std::launch::async, [&queue, &running, i]() { producer(queue, i); --running; }));
+	for (auto& task : producers)
+		task.get();
+	std::size_t count = 0;
+	for (auto& result : results)
+		count += result.get();
+	return count;
+}
+
+AUTO_TEST_CASE(FullQueueTests, 4, SmallQueue)
+	AUTO_TEST(1,
+	{
+		std::size_t value = 0;
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(FullQueueTests).empty());
+		TEST_PASSED(!pop(AUTO_TEST_GET_FIXTURE(FullQueueTests), value));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		for (std::size_t i = 0; i < 4; ++i)
+			TEST_PASSED(push(AUTO_TEST_GET_FIXTURE(FullQueueTests), i));
+		TEST_PASSED(!push(AUTO_TEST_GET_FIXTURE(FullQueueTests), 4));
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(FullQueueTests).empty());
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		std::size_t value = 4;
+		TEST_PASSED(pop(AUTO_TEST_GET_FIXTURE(FullQueueTests), value) && value == 0);
+		TEST_PASSED(push(AUTO_TEST_GET_FIXTURE(FullQueueTests), 4));
+		TEST_PASSED(!push(AUTO_TEST_GET_FIXTURE(FullQueueTests), 5));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		std::size_t value = 0;
+		for (std::size_t i = 1; i <= 4; ++i)
+			TEST_PASSED(pop(AUTO_TEST_GET_FIXTURE(FullQueueTests), value) && value == i);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(FullQueueTests).empty());
+		TEST_PASSED(!pop(AUTO_TEST_GET_FIXTURE(FullQueueTests), value));
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(WraparoundTests, 3, SmallQueue)
+	AUTO_TEST(1,
+	{
+		// Positions pass the capacity many times, every round starts in the next slot
+		for (std::size_t round = 0; round < 1000; ++round)
+			TEST_PASSED(pushThenPop(AUTO_TEST_GET_FIXTURE(WraparoundTests), round * 3, round * 3 + 3));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Queue is kept full while elements go through it
+		std::size_t value = 0;
+		for (std::size_t i = 0; i < 4; ++i)
+			TEST_PASSED(push(AUTO_TEST_GET_FIXTURE(WraparoundTests), i));
+		for (std::size_t i = 4; i < 1000; ++i)
+		{
+			TEST_PASSED(!push(AUTO_TEST_GET_FIXTURE(WraparoundTests), i));
+			TEST_PASSED(pop(AUTO_TEST_GET_FIXTURE(WraparoundTests), value) && value == i - 4);
+			TEST_PASSED(push(AUTO_TEST_GET_FIXTURE(WraparoundTests), i));
+		}
+		for (std::size_t i = 996; i < 1000; ++i)
+			TEST_PASSED(pop(AUTO_TEST_GET_FIXTURE(WraparoundTests), value) && value == i);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		// Slots taken with try_acquire are reused only after release, in any order of release
+		std::size_t first = 0;
+		std::size_t second = 0;
+		for (std::size_t i = 0; i < 4; ++i)
+			TEST_PASSED(push(AUTO_TEST_GET_FIXTURE(WraparoundTests), i));
+		std::size_t* value = AUTO_TEST_GET_FIXTURE(WraparoundTests).try_acquire(first);
+		TEST_PASSED(value && *value == 0);
+		value = AUTO_TEST_GET_FIXTURE(WraparoundTests).try_acquire(second);
+		TEST_PASSED(value && *value == 1);
+		AUTO_TEST_GET_FIXTURE(WraparoundTests).release(second);
+		TEST_PASSED(!push(AUTO_TEST_GET_FIXTURE(WraparoundTests), 4));
+		AUTO_TEST_GET_FIXTURE(WraparoundTests).release(first);
+		TEST_PASSED(push(AUTO_TEST_GET_FIXTURE(WraparoundTests), 4));
+		TEST_PASSED(push(AUTO_TEST_GET_FIXTURE(WraparoundTests), 5));
+		TEST_PASSED(!push(AUTO_TEST_GET_FIXTURE(WraparoundTests), 6));
+		TEST_PASSED(!AUTO_TEST_GET_FIXTURE(WraparoundTests).empty());
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(MultiProducerTests, 2, SharedQueue)
+	AUTO_TEST(1,
+	{
+		TEST_PASSED(produceAndConsume(AUTO_TEST_GET_FIXTURE(MultiProducerTests), 1) == PRODUCER_COUNT * PRODUCER_WORK_SIZE);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Elements are taken by several threads as producers do when they discard the oldest one
+		TEST_PASSED(produceAndConsume(AUTO_TEST_GET_FIXTURE(MultiProducerTests), 2) == PRODUCER_COUNT * PRODUCER_WORK_SIZE);
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(FullQueueTests,		tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(WraparoundTests,		tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(MultiProducerTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
@@ -0,0 +1,13 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <atomic>
+#include <array>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+/// CodeSnippets
+#include <DebugLib/mDebugLib.hpp>
+#include <DebugLib/cMpscQueue.hpp>
+#include "DebugLib_TestMacros.hpp"
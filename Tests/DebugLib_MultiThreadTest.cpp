@@ -1,6 +1,145 @@
 #include "DebugLib_MultiThreadTest.hpp"
 #define TREAD_WORK_SIZE ((unsigned long long)1 << 16)
 
+// Allocations are counted only while workers of allocationTest run
+static std::atomic<bool> countAllocations(false);
+static std::atomic<std::size_t> allocationCount(0);
+static std::atomic<int> readyWorkers(0);
+static std::atomic<bool> startWorkers(false);
+
+// Every replaceable form of operator new is counted
+static void* countedAllocation(std::size_t size) noexcept
+{
+	if (countAllocations.load(std::memory_order_relaxed))
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* memory = countedAllocation(size))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAllocation(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+#ifdef __cpp_aligned_new
+// Aligned block is preceded by pointer to the whole allocation
+static void* countedAlignedAllocation(std::size_t size, std::align_val_t alignment) noexcept
+{
+	const std::size_t align = static_cast<std::size_t>(alignment) < sizeof(void*) ? sizeof(void*) : static_cast<std::size_t>(alignment);
+	void* const memory = countedAllocation(size + align + sizeof(void*));
+	if (!memory)
+		return nullptr;
+	const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(memory) + sizeof(void*);
+	void** const aligned = reinterpret_cast<void**>((start + align - 1) & ~(align - 1));
+	aligned[-1] = memory;
+	return aligned;
+}
+
+static void alignedFree(void* memory) noexcept
+{
+	if (memory)
+		std::free(static_cast<void**>(memory)[-1]);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* memory = countedAlignedAllocation(size, alignment))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return countedAlignedAllocation(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return countedAlignedAllocation(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	alignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	alignedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	alignedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	alignedFree(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedFree(memory);
+}
+#endif
+
 void info_worker() 
 {
 	for (std::size_t i = 0; i < TREAD_WORK_SIZE; ++i)
@@ -47,6 +186,50 @@ void allTest()
 	}
 }
 
+// Waits until all workers are started, so thread creation is not counted
+void countedWorker(void (*worker)())
+{
+	++readyWorkers;
+	while (!startWorkers.load())
+		std::this_thread::yield();
+	worker();
+}
+
+bool allocationTest()
+{
+	// Writes the first message of this thread and starts the background writer if there is one
+	DEBUG_NEW_MESSAGE("#Test message")
+		DEBUG_PRINT("#Starting test with allocations counted");
+	DEBUG_END_MESSAGE
+
+	std::array< std::future<void>, 4 > tasks;
+	tasks[0] = std::async(std::launch::async, countedWorker, info_worker);
+	tasks[1] = std::async(std::launch::async, countedWorker, warning_worker);
+	tasks[2] = std::async(std::launch::async, countedWorker, error_worker);
+	tasks[3] = std::async(std::launch::async, countedWorker, user_worker);
+
+	while (readyWorkers.load() != 4)
+		std::this_thread::yield();
+	countAllocations.store(true);
+	startWorkers.store(true);
+	for (size_t i = 0; i < 4; i++)
+	{
+		tasks[i].wait();
+	}
+	countAllocations.store(false);
+	for (size_t i = 0; i < 4; i++)
+	{
+		tasks[i].get();
+	}
+
+	// Message capture and output must not allocate in steady state
+	const std::size_t count = allocationCount.load();
+	DEBUG_NEW_MESSAGE("#Test message")
+		DEBUG_PRINT("#Allocations made while workers were running: ", count);
+	DEBUG_END_MESSAGE
+	return count == 0;
+}
+
 void nooneTest()
 {
 	DEBUG_NEW_MESSAGE("#Test message")
@@ -70,6 +253,7 @@ void nooneTest()
 int main(void)
 {
 	allTest();
+	const bool allocationFree = allocationTest();
 	nooneTest();
-	return 0;
+	return allocationFree ? 0 : 1;
 }
\ No newline at end of file
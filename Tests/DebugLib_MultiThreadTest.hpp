@@ -1,7 +1,14 @@
 #pragma once
 /// STD
+#include <cstdlib>
+#include <cstdint>
 #include <future>
 #include <array>
+#include <atomic>
+#include <new>
+#include <thread>
 /// CodeSnippets
-#define DEBUG_LIB_TEST_MT
-#include <DebugLib\mDebugLib.hpp>
\ No newline at end of file
+#ifndef DEBUG_LIB_TEST_MT
+#	define DEBUG_LIB_TEST_MT
+#endif
+#include <DebugLib/mDebugLib.hpp>
\ No newline at end of file
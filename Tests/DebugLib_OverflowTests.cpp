@@ -0,0 +1,212 @@
+#include "DebugLib_OverflowTests.hpp"
+#define WAIT_LIMIT std::chrono::seconds(10)
+
+// DEBUG_LIB_ASYNC defines DEBUG_LIB_THREAD_SAFETY : LOG takes this mutex
+std::mutex DebugLib::Debug_Lib_Logger_Singletone_Mutex__;
+
+// Output of the background writer that holds it inside the first write until the gate is opened
+class GatedBuffer : public std::streambuf
+{
+public:
+
+	GatedBuffer() : opened(false), entered(false) {}
+
+	void open()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		opened = true;
+		changed.notify_all();
+	}
+
+	// Waits until the writer is held by the gate
+	bool waitEntered()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		return changed.wait_for(lock, WAIT_LIMIT, [this]() { return entered; });
+	}
+
+	// Waits until text is written
+	bool waitText(const char* value)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		return changed.wait_for(lock, WAIT_LIMIT, [this, value]() { return text.find(value) != std::string::npos; });
+	}
+
+	bool contains(const char* value)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return text.find(value) != std::string::npos;
+	}
+
+protected:
+
+	std::streamsize xsputn(const char* data, std::streamsize size) override
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		pass(lock);
+		text.append(data, static_cast<std::size_t>(size));
+		changed.notify_all();
+		return size;
+	}
+
+	int_type overflow(int_type value) override
+	{
+		if (traits_type::eq_int_type(value, traits_type::eof()))
+			return traits_type::not_eof(value);
+		const char data = traits_type::to_char_type(value);
+		xsputn(&data, 1);
+		return value;
+	}
+
+private:
+
+	void pass(std::unique_lock<std::mutex>& lock)
+	{
+		entered = true;
+		changed.notify_all();
+		changed.wait(lock, [this]() { return opened; });
+	}
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::string text;
+	bool opened;
+	bool entered;
+};
+
+static GatedBuffer output;
+static std::streambuf* previousOutput = nullptr;
+
+static void writeInfo(const char* text)
+{
+	DEBUG_INFO_MESSAGE
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+static void writeWarning(const char* text)
+{
+	DEBUG_WARNING_MESSAGE
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+static void writeError(const char* text)
+{
+	DEBUG_ERROR_MESSAGE
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+static void writeUser(const char* text)
+{
+	DEBUG_NEW_MESSAGE("#User")
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+static bool isPolicy(::DebugLib::OverflowPolicy policy)
+{
+	return DEBUG_LIB_ASYNC_OVERFLOW_POLICY == policy;
+}
+
+static bool droppedCounts(std::size_t info, std::size_t warning, std::size_t error, std::size_t user)
+{
+	return ::DebugLib::GetDroppedMessagesCount(::DebugLib::Level::Info) == info &&
+		::DebugLib::GetDroppedMessagesCount(::DebugLib::Level::Warning) == warning &&
+		::DebugLib::GetDroppedMessagesCount(::DebugLib::Level::Error) == error &&
+		::DebugLib::GetDroppedMessagesCount(::DebugLib::Level::User) == user &&
+		::DebugLib::GetDroppedMessagesCount(::DebugLib::Level::Nothing) == 0;
+}
+
+// Opens the gate when count messages are dropped
+static bool openWhenDropped(std::size_t count)
+{
+	const auto deadline = std::chrono::steady_clock::now() + WAIT_LIMIT;
+	while (::DebugLib::GetDroppedMessagesCount() < count && std::chrono::steady_clock::now() < deadline)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	const bool dropped = ::DebugLib::GetDroppedMessagesCount() == count;
+	output.open();
+	return dropped;
+}
+
+// Messages that do not fit into the full queue : producer returns only after the writer passes the gate
+static bool overflowDropOldest()
+{
+	std::future<bool> opener = std::async(std::launch::async, openWhenDropped, 3);
+	writeInfo("Message E");
+	return opener.get();
+}
+
+AUTO_TEST_CASE(OverflowPolicyTests, 4, int)
+	AUTO_TEST(1,
+	{
+		// Writer takes the first message and is held by the gate, three slots are left for the next messages
+		previousOutput = DEBUG_OUT.rdbuf(&output);
+		writeInfo("Message A");
+		TEST_PASSED(output.waitEntered());
+		writeWarning("Message B");
+		writeError("Message C");
+		writeUser("Message D");
+		TEST_PASSED(::DebugLib::GetDroppedMessagesCount() == 0);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		if (isPolicy(::DebugLib::OverflowPolicy::DropOldest))
+		{
+			// Queued messages B, C and D are dropped, producer of E waits for the slot of A
+			TEST_PASSED(overflowDropOldest());
+			TEST_PASSED(droppedCounts(0, 1, 1, 1));
+		}
+		else
+		{
+			// Messages E, F and G are dropped by their producers, with a wait for DropAfterWait
+			writeInfo("Message E");
+			writeInfo("Message F");
+			writeError("Message G");
+			TEST_PASSED(droppedCounts(2, 0, 1, 0));
+			output.open();
+		}
+		TEST_PASSED(::DebugLib::GetDroppedMessagesCount() == 3);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		// Report follows the messages that were kept
+		TEST_PASSED(output.waitText("messages dropped on full output queue"));
+		TEST_PASSED(output.contains("Message A"));
+		if (isPolicy(::DebugLib::OverflowPolicy::DropOldest))
+		{
+			// Message E may be taken after the report
+			TEST_PASSED(output.waitText("Message E"));
+			TEST_PASSED(!output.contains("Message B") && !output.contains("Message C") && !output.contains("Message D"));
+			TEST_PASSED(output.contains("\tWARNING 1\n\tERROR 1\n\tUSER 1\n") && !output.contains("\tINFO "));
+		}
+		else
+		{
+			TEST_PASSED(output.contains("Message B") && output.contains("Message C") && output.contains("Message D"));
+			TEST_PASSED(!output.contains("Message E") && !output.contains("Message F") && !output.contains("Message G"));
+			TEST_PASSED(output.contains("\tINFO 2\n\tERROR 1\n") && !output.contains("\tWARNING ") && !output.contains("\tUSER "));
+		}
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Messages that fit are written again
+		writeInfo("Message H");
+		TEST_PASSED(output.waitText("Message H"));
+		TEST_PASSED(::DebugLib::GetDroppedMessagesCount() == 3);
+		DEBUG_OUT.rdbuf(previousOutput);
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(OverflowPolicyTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
@@ -0,0 +1,16 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+/// CodeSnippets
+#ifndef DEBUG_LIB_TEST_OVERFLOW
+#	define DEBUG_LIB_TEST_OVERFLOW ::DebugLib::OverflowPolicy::DropNewest
+#endif
+#include <DebugLib/mDebugLib.hpp>
+#include "DebugLib_TestMacros.hpp"
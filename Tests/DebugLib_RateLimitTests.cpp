@@ -0,0 +1,161 @@
+#include "DebugLib_RateLimitTests.hpp"
+
+// Result of messages of one call site : passed messages and suppressed counts reported by summaries
+struct SuppressionResult
+{
+	std::size_t passed;
+	std::uint64_t reported;
+	std::size_t summaries;
+};
+
+static std::string siteHeader(const char* level, int line)
+{
+	return std::string(level) + "::" __FILE__ ":" + std::to_string(line);
+}
+
+// Sums counts of the site in all summaries written to output
+static void readSummaries(const std::string& output, const std::string& header, SuppressionResult& result)
+{
+	std::istringstream lines(output);
+	std::string line;
+	const std::string prefix = '\t' + header + ' ';
+	while (std::getline(lines, line))
+		if (!line.compare(0, prefix.size(), prefix))
+		{
+			result.reported += std::stoull(line.substr(prefix.size()));
+			++result.summaries;
+		}
+}
+
+// Runs write with DEBUG_OUT redirected to memory and reads summaries of the site written meanwhile
+static SuppressionResult capture(std::size_t (*write)(std::size_t), std::size_t count, const char* level, int line)
+{
+	SuppressionResult result = {};
+	std::stringbuf output;
+	std::streambuf* const previous = DEBUG_OUT.rdbuf(&output);
+	result.passed = write(count);
+	DEBUG_OUT.rdbuf(previous);
+	readSummaries(output.str(), siteHeader(level, line), result);
+	return result;
+}
+
+static const int sampledLine = __LINE__ + 5;
+static std::size_t writeSampled(std::size_t count)
+{
+	std::size_t passed = 0;
+	for (std::size_t i = 0; i < count; ++i)
+		DEBUG_INFO_MESSAGE_SAMPLED(4)
+			DEBUG_PRINT("Sampled message ", i);
+			++passed;
+		DEBUG_END_MESSAGE
+	return passed;
+}
+
+static const int limitedLine = __LINE__ + 5;
+static std::size_t writeLimited(std::size_t count)
+{
+	std::size_t passed = 0;
+	for (std::size_t i = 0; i < count; ++i)
+		DEBUG_WARNING_MESSAGE_LIMITED(2, 60000)
+			DEBUG_PRINT("Limited message ", i);
+			++passed;
+		DEBUG_END_MESSAGE
+	return passed;
+}
+
+static const int blockedLine = __LINE__ + 5;
+static std::size_t writeBlocked(std::size_t count)
+{
+	std::size_t passed = 0;
+	for (std::size_t i = 0; i < count; ++i)
+		DEBUG_ERROR_MESSAGE_LIMITED(0, 60000)
+			DEBUG_PRINT("Blocked message ", i);
+			++passed;
+		DEBUG_END_MESSAGE
+	return passed;
+}
+
+static const int windowLine = __LINE__ + 5;
+static std::size_t writeWindow(std::size_t count)
+{
+	std::size_t passed = 0;
+	for (std::size_t i = 0; i < count; ++i)
+		DEBUG_INFO_MESSAGE_LIMITED(1, 20)
+			DEBUG_PRINT("Window message ", i);
+			++passed;
+		DEBUG_END_MESSAGE
+	return passed;
+}
+
+AUTO_TEST_CASE(SampledMessageTests, 2, int)
+	AUTO_TEST(1,
+	{
+		// Messages 1, 5 and 9 pass : 3 sampled out messages are reported with each of 5 and 9
+		const SuppressionResult summary = capture(writeSampled, 10, "INFO", sampledLine);
+		TEST_PASSED(summary.passed == 3);
+		TEST_PASSED(summary.reported == 6);
+		TEST_PASSED(summary.summaries == 2);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Message 10 of the previous run is counted by the thread until message 13 passes
+		const SuppressionResult summary = capture(writeSampled, 4, "INFO", sampledLine);
+		TEST_PASSED(summary.passed == 1);
+		TEST_PASSED(summary.reported == 3);
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(LimitedMessageTests, 4, int)
+	AUTO_TEST(1,
+	{
+		// Suppressed messages 1, 2, 4 and 8 of the window read the clock and report counts
+		const SuppressionResult summary = capture(writeLimited, 10, "WARNING", limitedLine);
+		TEST_PASSED(summary.passed == 2);
+		TEST_PASSED(summary.reported == 8);
+		TEST_PASSED(summary.summaries == 4);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Suppressed messages 16, 32 and 64 read the clock and then every DEBUG_LIB_SUPPRESSION_CHECK_PERIOD-th
+		const SuppressionResult summary = capture(writeLimited, 300 - 10, "WARNING", limitedLine);
+		TEST_PASSED(summary.passed == 0);
+		TEST_PASSED(summary.reported == 256 - 8);
+		TEST_PASSED(summary.summaries == 6);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		const SuppressionResult summary = capture(writeBlocked, 10, "ERROR", blockedLine);
+		TEST_PASSED(summary.passed == 0);
+		TEST_PASSED(summary.reported == 8);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Suppressed message after the end of the window passes and starts the next window
+		SuppressionResult summary = capture(writeWindow, 2, "INFO", windowLine);
+		TEST_PASSED(summary.passed == 1);
+		TEST_PASSED(summary.reported == 1);
+		std::this_thread::sleep_for(std::chrono::milliseconds(40));
+		summary = capture(writeWindow, 1, "INFO", windowLine);
+		TEST_PASSED(summary.passed == 1);
+		TEST_PASSED(summary.reported == 0);
+		summary = capture(writeWindow, 1, "INFO", windowLine);
+		TEST_PASSED(summary.passed == 0);
+		TEST_PASSED(summary.reported == 1);
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(SampledMessageTests,	tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(LimitedMessageTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
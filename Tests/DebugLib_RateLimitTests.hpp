@@ -0,0 +1,15 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+/// CodeSnippets
+#ifndef DEBUG_LIB_TEST_RATE_LIMIT
+#	define DEBUG_LIB_TEST_RATE_LIMIT
+#endif
+#include <DebugLib/mDebugLib.hpp>
+#include "DebugLib_TestMacros.hpp"
@@ -166,6 +166,35 @@ AUTO_TEST_CASE(VariadicPrintMacroTests, 4, ::DebugLibTests::OutputCounter)
 	})
 AUTO_TEST_CASE_END
 
+AUTO_TEST_CASE(ManipulatorMacroTests, 3, ::std::ostringstream)
+#define DEBUG_OUT AUTO_TEST_GET_FIXTURE(ManipulatorMacroTests)
+	AUTO_TEST(1,
+	{
+		DEBUG_WRITE(1, ::std::endl, 2, ::std::flush);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ManipulatorMacroTests).str() == "1\n2");
+		AUTO_TEST_INCREMENT;
+		AUTO_TEST_GET_FIXTURE(ManipulatorMacroTests).str("");
+	})
+	AUTO_TEST(2,
+	{
+		DEBUG_PRINT(::std::hex, 255, ::std::endl, ::std::dec, 255);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ManipulatorMacroTests).str() == "ff\n255\n");
+		AUTO_TEST_INCREMENT;
+		AUTO_TEST_GET_FIXTURE(ManipulatorMacroTests).str("");
+	})
+#undef DEBUG_LIB_NEXT_LINE
+#define DEBUG_LIB_NEXT_LINE ::std::endl
+	AUTO_TEST(3,
+	{
+		DEBUG_PRINT("a", 1);
+		TEST_PASSED(AUTO_TEST_GET_FIXTURE(ManipulatorMacroTests).str() == "a1\n");
+		AUTO_TEST_INCREMENT;
+		AUTO_TEST_GET_FIXTURE(ManipulatorMacroTests).str("");
+	})
+#undef DEBUG_LIB_NEXT_LINE
+#define DEBUG_LIB_NEXT_LINE '\n'
+AUTO_TEST_CASE_END
+
 AUTO_TEST_CASE(InfoMessageTest, 4, ::DebugLibTests::OutputCounter)
 #define DEBUG_OUT AUTO_TEST_GET_FIXTURE(InfoMessageTest)
 	AUTO_TEST(1,
@@ -352,6 +381,7 @@ int main(void)
 	REGISTER_TEST(VariadicWriteMacroTests,	tottal_tests_count, passed_tests_count);
 	REGISTER_TEST(PrintMacroTests,			tottal_tests_count, passed_tests_count);
 	REGISTER_TEST(VariadicPrintMacroTests,	tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(ManipulatorMacroTests,	tottal_tests_count, passed_tests_count);
 	REGISTER_TEST(InfoMessageTest,			tottal_tests_count, passed_tests_count);
 	REGISTER_TEST(WarningMessageTest,		tottal_tests_count, passed_tests_count);
 	REGISTER_TEST(ErrorMessageTest,			tottal_tests_count, passed_tests_count);
@@ -0,0 +1,158 @@
+#include "DebugLib_SinkTests.hpp"
+
+// Sink that keeps the text of every message it receives
+class CaptureSink : public ::DebugLib::Sink
+{
+public:
+
+	CaptureSink() : flushes(0) {}
+
+	void write(const ::DebugLib::Record& record, const char* stamp) override
+	{
+		messages.push_back(std::string(stamp) + std::string(record.data, record.size));
+	}
+
+	void flush() override
+	{
+		++flushes;
+	}
+
+	// Checks whether the last message received by the sink contains text
+	bool received(const char* text) const
+	{
+		return !messages.empty() && messages.back().find(text) != std::string::npos;
+	}
+
+	std::vector<std::string> messages;
+	std::size_t flushes;
+};
+
+static void writeInfo(const char* text)
+{
+	DEBUG_INFO_MESSAGE
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+static void writeWarning(const char* text)
+{
+	DEBUG_WARNING_MESSAGE
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+static void writeError(const char* text)
+{
+	DEBUG_ERROR_MESSAGE
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+static void writeUser(const char* text)
+{
+	DEBUG_NEW_MESSAGE("#User")
+		DEBUG_PRINT(text);
+	DEBUG_END_MESSAGE
+}
+
+// Text written by write to DEBUG_OUT through the default sink
+static std::string defaultOutput(void (*write)(const char*), const char* text)
+{
+	std::stringbuf output;
+	std::streambuf* const previous = DEBUG_OUT.rdbuf(&output);
+	write(text);
+	DEBUG_OUT.rdbuf(previous);
+	return output.str();
+}
+
+// Sinks of all messages and of warnings and higher
+static std::shared_ptr<CaptureSink> allSink = std::make_shared<CaptureSink>();
+static std::shared_ptr<CaptureSink> warningSink = std::make_shared<CaptureSink>();
+static std::size_t allId = ::DebugLib::DefaultSink;
+static std::size_t warningId = ::DebugLib::DefaultSink;
+
+AUTO_TEST_CASE(DefaultSinkTests, 2, int)
+	AUTO_TEST(1,
+	{
+		TEST_PASSED(defaultOutput(writeInfo, "Default info").find("Default info") != std::string::npos);
+		TEST_PASSED(defaultOutput(writeUser, "Default user").find("Default user") != std::string::npos);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		TEST_PASSED(::DebugLib::SetSinkLevel(::DebugLib::DefaultSink, ::DebugLib::Level::Error));
+		TEST_PASSED(defaultOutput(writeWarning, "Default warning").empty());
+		TEST_PASSED(defaultOutput(writeError, "Default error").find("Default error") != std::string::npos);
+		// Default sink stays paused for the next tests
+		TEST_PASSED(::DebugLib::SetSinkLevel(::DebugLib::DefaultSink, ::DebugLib::Level::Nothing));
+		TEST_PASSED(defaultOutput(writeUser, "Default paused").empty());
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+AUTO_TEST_CASE(SinkFanOutTests, 4, int)
+	AUTO_TEST(1,
+	{
+		allId = ::DebugLib::AddSink(allSink, ::DebugLib::Level::All);
+		warningId = ::DebugLib::AddSink(warningSink, ::DebugLib::Level::Warning);
+		TEST_PASSED(allId != ::DebugLib::DefaultSink && warningId != ::DebugLib::DefaultSink && allId != warningId);
+		writeInfo("Fan-out info");
+		TEST_PASSED(allSink->received("Fan-out info") && allSink->messages.size() == 1);
+		TEST_PASSED(warningSink->messages.empty());
+		writeWarning("Fan-out warning");
+		writeError("Fan-out error");
+		writeUser("Fan-out user");
+		TEST_PASSED(allSink->messages.size() == 4 && warningSink->messages.size() == 3);
+		TEST_PASSED(warningSink->messages[0].find("WARNING::") == 0 && warningSink->messages[1].find("ERROR::") == 0);
+		TEST_PASSED(allSink->received("Fan-out user") && warningSink->received("Fan-out user"));
+		TEST_PASSED(allSink->messages[3] == warningSink->messages[2]);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(2,
+	{
+		// Sinks are flushed after messages written to them only
+		const std::size_t flushes = warningSink->flushes;
+		TEST_PASSED(allSink->flushes >= 1 && flushes >= 1);
+		writeInfo("Flushed info");
+		TEST_PASSED(allSink->received("Flushed info") && warningSink->flushes == flushes);
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(3,
+	{
+		TEST_PASSED(::DebugLib::SetSinkLevel(warningId, ::DebugLib::Level::User));
+		writeError("Raised error");
+		TEST_PASSED(allSink->received("Raised error") && !warningSink->received("Raised error"));
+		writeUser("Raised user");
+		TEST_PASSED(warningSink->received("Raised user"));
+		TEST_PASSED(::DebugLib::SetSinkLevel(allId, ::DebugLib::Level::Nothing));
+		writeUser("Paused user");
+		TEST_PASSED(!allSink->received("Paused user") && warningSink->received("Paused user"));
+		TEST_PASSED(!::DebugLib::SetSinkLevel(warningId + 1, ::DebugLib::Level::All));
+		AUTO_TEST_INCREMENT;
+	})
+	AUTO_TEST(4,
+	{
+		// Removed sink is released by the writing thread on the next message
+		TEST_PASSED(::DebugLib::SetSinkLevel(allId, ::DebugLib::Level::All));
+		TEST_PASSED(::DebugLib::RemoveSink(allId));
+		TEST_PASSED(!::DebugLib::RemoveSink(allId));
+		const std::size_t received = allSink->messages.size();
+		writeError("Removed error");
+		TEST_PASSED(allSink->messages.size() == received && warningSink->messages.size() == 5);
+		TEST_PASSED(allSink.use_count() == 1);
+		TEST_PASSED(::DebugLib::RemoveSink(warningId));
+		writeUser("No sinks");
+		TEST_PASSED(warningSink.use_count() == 1 && !warningSink->received("No sinks"));
+		AUTO_TEST_INCREMENT;
+	})
+AUTO_TEST_CASE_END
+
+int main(void)
+{
+	std::size_t tottal_tests_count = 0;
+	std::size_t passed_tests_count = 0;
+	REGISTER_TEST(DefaultSinkTests,	tottal_tests_count, passed_tests_count);
+	REGISTER_TEST(SinkFanOutTests,	tottal_tests_count, passed_tests_count);
+	LOG("Total tests passed %d out of %d",	passed_tests_count, tottal_tests_count)
+	return tottal_tests_count == passed_tests_count ? 0 : 2;
+}
@@ -0,0 +1,14 @@
+#pragma once
+/// STD
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+/// CodeSnippets
+#ifndef DEBUG_LIB_TEST_SINKS
+#	define DEBUG_LIB_TEST_SINKS
+#endif
+#include <DebugLib/mDebugLib.hpp>
+#include "DebugLib_TestMacros.hpp"
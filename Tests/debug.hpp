@@ -1,11 +1,32 @@
 #pragma once
-#define DEBUG
+#ifndef DEBUG
+#   define DEBUG
+#endif
 #define DEBUG_LIB_TEST
 
 #ifdef DEBUG_LIB_TEST_MT
 #   define DEBUG_LIB_THREAD_SAFETY
 #   define DEBUG_LIB_FILE_LOG
 #   define DEBUG_LIB_LOG_FILE_NAME "DebugLib_MT.log"
+#   ifdef DEBUG_LIB_TEST_ASYNC
+#       define DEBUG_LIB_ASYNC
+#   endif
+#elif defined(DEBUG_LIB_TEST_BINARY)
+#   define DEBUG_LIB_BINARY_LOG
+#elif defined(DEBUG_LIB_TEST_RATE_LIMIT)
+//  Every flush of suppressed counts writes a summary
+#   define DEBUG_LIB_SUPPRESSION_SUMMARY_PERIOD 0
+#elif defined(DEBUG_LIB_TEST_SINKS)
+#   define DEBUG_LIB_SINKS
+#elif defined(DEBUG_LIB_TEST_METRICS)
+#   define DEBUG_LIB_METRICS
+//  Only the snapshot on exit is written
+#   define DEBUG_LIB_METRICS_PERIOD 0
+#elif defined(DEBUG_LIB_TEST_OVERFLOW)
+//  Overflow policy under test is the value of DEBUG_LIB_TEST_OVERFLOW
+#   define DEBUG_LIB_ASYNC
+#   define DEBUG_LIB_ASYNC_QUEUE_SIZE 4
+#   define DEBUG_LIB_ASYNC_OVERFLOW_POLICY DEBUG_LIB_TEST_OVERFLOW
 #else
 namespace DebugLibTests
 {
@@ -0,0 +1,53 @@
+/**
+*	DESCRIPTION:
+*		Converts binary log written with DEBUG_LIB_BINARY_LOG to the text layout of DebugLib.
+*		Usage: DebugLibDecoder <binary log> [text log]
+*		If text log is not provided the result is written to standard output.
+*		Time frames written with DEBUG_LIB_TIMESTAMP are printed as "[...] " prefix of the next message.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+**/
+/// STD
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+/// CodeSnippets
+#include <DebugLib/cBinaryRecord.hpp>
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		::std::cerr << "Usage: " << argv[0] << " <binary log> [text log]" << ::std::endl;
+		return 1;
+	}
+	::std::ifstream input(argv[1], ::std::ios::in | ::std::ios::binary);
+	if (!input)
+	{
+		::std::cerr << "Can't open: " << argv[1] << ::std::endl;
+		return 1;
+	}
+	const ::std::vector<char> log((::std::istreambuf_iterator<char>(input)), ::std::istreambuf_iterator<char>());
+	::std::ofstream file;
+	if (argc == 3)
+	{
+		file.open(argv[2], ::std::ios::out | ::std::ios::trunc);
+		if (!file)
+		{
+			::std::cerr << "Can't open: " << argv[2] << ::std::endl;
+			return 1;
+		}
+	}
+	::std::ostream& out = argc == 3 ? file : ::std::cout;
+	const ::std::size_t decoded = ::DebugLib::DecodeBinaryLog(out, log.data(), log.size());
+	out << ::std::flush;
+	if (decoded != log.size())
+	{
+		::std::cerr << "Malformed frame at offset: " << decoded << ::std::endl;
+		return 2;
+	}
+	return 0;
+}
@@ -0,0 +1,344 @@
+/**
+*	DESCRIPTION:
+*		Searches text log of DebugLib in parallel.
+*		Usage: DebugLibQuery [-l level] [-f file] [-t text] [-j threads] <log> [index]
+*			-l level   : print messages of this level and higher (INFO, WARNING, ERROR, USER)
+*			-f file    : print messages which source file name contains this string (user messages have no file)
+*			-t text    : print messages which content contains this string
+*			-j threads : count of worker threads (hardware concurrency by default)
+*		Index written with DEBUG_LIB_LOG_INDEX is used if present (<log>.idx by default), so
+*		level and file filters do not touch the log. Without index log is split into chunks
+*		at message headers and every chunk is scanned by its own thread.
+*		Matched messages are printed in order of appearance in log.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+**/
+/// STD
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+/// POSIX
+#if defined(LINUX) || defined(__unix__)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+/// CodeSnippets
+#include <DebugLib/cLogIndex.hpp>
+
+namespace
+{
+	const char* const LevelNames[] = { "INFO", "WARNING", "ERROR", "USER" };
+	const int LevelCount = 4;
+
+	/**
+	 *	@brief Read-only view of a file content.
+	 *	File is mapped to memory where possible and read to a buffer otherwise.
+	 */
+	class FileView
+	{
+	public:
+
+		FileView() : begin(nullptr), length(0) {}
+
+		~FileView()
+		{
+#if defined(LINUX) || defined(__unix__)
+			if (begin && buffer.empty())
+				munmap(const_cast<char*>(begin), length);
+#endif
+		}
+
+		bool open(const char* name)
+		{
+#if defined(LINUX) || defined(__unix__)
+			const int fd = ::open(name, O_RDONLY);
+			if (fd < 0)
+				return false;
+			struct stat info;
+			if (fstat(fd, &info) != 0)
+			{
+				close(fd);
+				return false;
+			}
+			length = static_cast<::std::size_t>(info.st_size);
+			if (length)
+			{
+				void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (mapped == MAP_FAILED)
+				{
+					close(fd);
+					return false;
+				}
+				madvise(mapped, length, MADV_SEQUENTIAL);
+				begin = static_cast<const char*>(mapped);
+			}
+			close(fd);
+			return true;
+#else
+			::std::ifstream input(name, ::std::ios::in | ::std::ios::binary);
+			if (!input)
+				return false;
+			buffer.assign(::std::istreambuf_iterator<char>(input), ::std::istreambuf_iterator<char>());
+			begin = buffer.data();
+			length = buffer.size();
+			return true;
+#endif
+		}
+
+		const char* data() const { return begin; }
+		::std::size_t size() const { return length; }
+
+	private:
+		const char* begin;
+		::std::size_t length;
+		::std::vector<char> buffer;
+
+		FileView(const FileView&) = delete;
+		FileView& operator=(const FileView&) = delete;
+	};
+
+	struct Query
+	{
+		int level = 0;
+		::std::string file;
+		::std::string text;
+	};
+
+	/**
+	 *	@brief Part of log occupied by one message.
+	 */
+	struct Span
+	{
+		::std::size_t offset;
+		::std::size_t length;
+	};
+
+	bool contains(const char* data, ::std::size_t size, const ::std::string& pattern)
+	{
+		return pattern.empty() || ::std::search(data, data + size, pattern.begin(), pattern.end()) != data + size;
+	}
+
+	/**
+	 *	@brief Recognizes the first line of a message in form "LEVEL::file:line".
+	 *	Timestamp prefix "[...] " written with DEBUG_LIB_TIMESTAMP is skipped.
+	 *	@return Level of message or -1 if line is not a message header.
+	 */
+	int parseHeader(const char* line, const char* end, const char*& file, ::std::size_t& fileLength)
+	{
+		if (line < end && *line == '[')
+		{
+			const char* close = static_cast<const char*>(::std::memchr(line, ']', static_cast<::std::size_t>(end - line)));
+			if (close && end - close > 1 && close[1] == ' ')
+				line = close + 2;
+		}
+		for (int level = 0; level < LevelCount; ++level)
+		{
+			const ::std::size_t nameLength = ::std::strlen(LevelNames[level]);
+			if (static_cast<::std::size_t>(end - line) < nameLength + 2 || ::std::memcmp(line, LevelNames[level], nameLength) != 0 ||
+				line[nameLength] != ':' || line[nameLength + 1] != ':')
+				continue;
+			file = line + nameLength + 2;
+			const char* colon = end;
+			while (colon > file && *(colon - 1) != ':')
+				--colon;
+			fileLength = colon > file ? static_cast<::std::size_t>(colon - 1 - file) : 0;
+			return level;
+		}
+		return -1;
+	}
+
+	/**
+	 *	@brief Runs job for every part of [0, count) on its own thread.
+	 */
+	template < typename Job >
+	void parallel(::std::size_t count, unsigned threads, Job&& job)
+	{
+		threads = static_cast<unsigned>(::std::min<::std::size_t>(threads, count ? count : 1));
+		::std::vector<::std::thread> workers;
+		for (unsigned i = 1; i < threads; ++i)
+			workers.emplace_back(job, count * i / threads, count * (i + 1) / threads, i);
+		job(0, count / threads, 0u);
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	/**
+	 *	@brief Filters messages using log index.
+	 */
+	::std::vector<::std::vector<Span>> queryIndex(const FileView& log, const ::std::vector<::DebugLib::IndexEntry>& entries,
+		const ::std::vector<::std::string>& files, const Query& query, unsigned threads)
+	{
+		::std::vector<bool> fileMatch(files.size());
+		for (::std::size_t i = 0; i < files.size(); ++i)
+			fileMatch[i] = files[i].find(query.file) != ::std::string::npos;
+		::std::vector<::std::vector<Span>> results(threads);
+		parallel(entries.size(), threads, [&](::std::size_t first, ::std::size_t last, unsigned id)
+		{
+			for (::std::size_t i = first; i < last; ++i)
+			{
+				const ::DebugLib::IndexEntry& entry = entries[i];
+				if (entry.level < query.level)
+					continue;
+				if (!query.file.empty() && (entry.file >= files.size() || !fileMatch[entry.file]))
+					continue;
+				if (entry.offset + entry.length > log.size())
+					continue;
+				if (!contains(log.data() + entry.offset, entry.length, query.text))
+					continue;
+				results[id].push_back({ static_cast<::std::size_t>(entry.offset), entry.length });
+			}
+		});
+		return results;
+	}
+
+	/**
+	 *	@brief Filters messages by scanning log for message headers.
+	 *	Every chunk begins at the first header after its nominal start, so each message is
+	 *	scanned by exactly one thread. Text before the first header forms a message of user level.
+	 */
+	::std::vector<::std::vector<Span>> queryLog(const FileView& log, const Query& query, unsigned threads)
+	{
+		const char* const data = log.data();
+		const ::std::size_t size = log.size();
+		// Finds the start of the first header line at or after offset
+		const auto nextHeader = [data, size](::std::size_t offset)
+		{
+			if (offset)
+			{
+				const char* line = static_cast<const char*>(::std::memchr(data + offset - 1, '\n', size - offset + 1));
+				offset = line ? static_cast<::std::size_t>(line - data) + 1 : size;
+			}
+			while (offset < size)
+			{
+				const char* newline = static_cast<const char*>(::std::memchr(data + offset, '\n', size - offset));
+				const char* end = newline ? newline : data + size;
+				const char* file;
+				::std::size_t fileLength;
+				if (parseHeader(data + offset, end, file, fileLength) >= 0)
+					return offset;
+				offset = newline ? static_cast<::std::size_t>(newline - data) + 1 : size;
+			}
+			return size;
+		};
+		::std::vector<::std::vector<Span>> results(threads);
+		parallel(size, threads, [&](::std::size_t first, ::std::size_t last, unsigned id)
+		{
+			::std::size_t begin = first ? nextHeader(first) : 0;
+			const ::std::size_t stop = last < size ? nextHeader(last) : size;
+			while (begin < stop)
+			{
+				const char* newline = static_cast<const char*>(::std::memchr(data + begin, '\n', size - begin));
+				const char* lineEnd = newline ? newline : data + size;
+				const char* file = nullptr;
+				::std::size_t fileLength = 0;
+				int level = parseHeader(data + begin, lineEnd, file, fileLength);
+				// Header of user message is arbitrary text so it has no source file like in index
+				if (level < 0 || level == LevelCount - 1)
+				{
+					level = LevelCount - 1;
+					file = nullptr;
+				}
+				const ::std::size_t end = newline ? ::std::min(nextHeader(static_cast<::std::size_t>(newline - data) + 1), stop) : size;
+				if (level >= query.level &&
+					(query.file.empty() || (file && contains(file, fileLength, query.file))) &&
+					contains(data + begin, end - begin, query.text))
+					results[id].push_back({ begin, end - begin });
+				begin = end;
+			}
+		});
+		return results;
+	}
+
+	int usage(const char* name)
+	{
+		::std::cerr << "Usage: " << name << " [-l level] [-f file] [-t text] [-j threads] <log> [index]" << ::std::endl;
+		return 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Query query;
+	unsigned threads = ::std::max(1u, ::std::thread::hardware_concurrency());
+	::std::vector<const char*> positional;
+	for (int i = 1; i < argc; ++i)
+	{
+		const ::std::string option = argv[i];
+		if (option.size() == 2 && option[0] == '-')
+		{
+			if (++i == argc)
+				return usage(argv[0]);
+			switch (option[1])
+			{
+			case 'l':
+			{
+				const auto found = ::std::find_if(::std::begin(LevelNames), ::std::end(LevelNames),
+					[&](const char* name) { return ::std::strcmp(name, argv[i]) == 0; });
+				if (found == ::std::end(LevelNames))
+					return usage(argv[0]);
+				query.level = static_cast<int>(found - ::std::begin(LevelNames));
+				break;
+			}
+			case 'f':
+				query.file = argv[i];
+				break;
+			case 't':
+				query.text = argv[i];
+				break;
+			case 'j':
+				threads = static_cast<unsigned>(::std::max(1, ::std::atoi(argv[i])));
+				break;
+			default:
+				return usage(argv[0]);
+			}
+		}
+		else
+			positional.push_back(argv[i]);
+	}
+	if (positional.empty() || positional.size() > 2)
+		return usage(argv[0]);
+
+	FileView log;
+	if (!log.open(positional[0]))
+	{
+		::std::cerr << "Can't open: " << positional[0] << ::std::endl;
+		return 1;
+	}
+	const ::std::string indexName = positional.size() == 2 ? positional[1] : ::std::string(positional[0]) + ".idx";
+	FileView index;
+	::std::vector<::std::vector<Span>> results;
+	if (index.open(indexName.c_str()))
+	{
+		::std::vector<::DebugLib::IndexEntry> entries;
+		::std::vector<::std::string> files;
+		if (!::DebugLib::ReadIndex(index.data(), index.size(), entries, files))
+			::std::cerr << "Malformed index: " << indexName << ", only entries before the error are used" << ::std::endl;
+		results = queryIndex(log, entries, files, query, threads);
+	}
+	else
+	{
+		if (positional.size() == 2)
+		{
+			::std::cerr << "Can't open: " << indexName << ::std::endl;
+			return 1;
+		}
+		results = queryLog(log, query, threads);
+	}
+
+	for (const auto& part : results)
+		for (const Span& span : part)
+			::std::cout.write(log.data() + span.offset, span.length);
+	::std::cout << ::std::flush;
+	return 0;
+}
@@ -0,0 +1,140 @@
+/**
+*	DESCRIPTION:
+*		Expands call site identifiers of text log written with DEBUG_LIB_SITE_IDS back to message headers.
+*		Usage: DebugLibSites <site table> <log> [expanded log]
+*		Site table is DEBUG_LIB_SITE_TABLE_FILE_NAME (<log>.sites by default). If expanded log is not provided
+*		the result is written to standard output. Timestamp prefix "[...] " written with DEBUG_LIB_TIMESTAMP is kept.
+*	AUTHOR:
+*		Mikhail Demchenko
+*		mailto:dev.echo.mike@gmail.com
+*		https://github.com/echo-Mike
+**/
+/// STD
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+/// CodeSnippets
+#include <DebugLib/cSiteTable.hpp>
+
+namespace
+{
+	/**
+	 *	@brief Reads "@xxxxxxxx header" lines of site table.
+	 *	Identifier written with different headers (by runs that registered colliding headers) is ambiguous.
+	 *	@return Count of malformed lines.
+	 */
+	::std::size_t readTable(::std::istream& in, ::std::unordered_map<::std::uint32_t, ::std::string>& sites,
+		::std::unordered_set<::std::uint32_t>& ambiguous)
+	{
+		::std::size_t malformed = 0;
+		::std::string line;
+		while (::std::getline(in, line))
+		{
+			::std::uint32_t id;
+			const char* const data = line.c_str();
+			if (line.size() < DEBUG_LIB_SITE_ID_TEXT_SIZE || line[DEBUG_LIB_SITE_ID_TEXT_SIZE - 1] != ' ' ||
+				!::DebugLib::ParseSiteId(data, data + DEBUG_LIB_SITE_ID_TEXT_SIZE - 1, id))
+			{
+				++malformed;
+				continue;
+			}
+			const auto site = sites.emplace(id, line.substr(DEBUG_LIB_SITE_ID_TEXT_SIZE));
+			if (!site.second && site.first->second.compare(data + DEBUG_LIB_SITE_ID_TEXT_SIZE))
+				ambiguous.insert(id);
+		}
+		return malformed;
+	}
+
+	/**
+	 *	@brief Copies log replacing lines that consist of a known site identifier with the header.
+	 *	@return Count of identifiers that are not in the table or are ambiguous, such lines are copied as they are.
+	 */
+	::std::size_t expand(::std::istream& in, ::std::ostream& out, const ::std::unordered_map<::std::uint32_t, ::std::string>& sites,
+		const ::std::unordered_set<::std::uint32_t>& ambiguous)
+	{
+		::std::size_t unknown = 0;
+		::std::string line;
+		while (::std::getline(in, line))
+		{
+			const char* begin = line.c_str();
+			const char* const end = begin + line.size();
+			if (begin < end && *begin == '[')
+			{
+				const char* close = static_cast<const char*>(::std::memchr(begin, ']', line.size()));
+				if (close && end - close > 1 && close[1] == ' ')
+					begin = close + 2;
+			}
+			::std::uint32_t id;
+			if (::DebugLib::ParseSiteId(begin, end, id))
+			{
+				const auto site = sites.find(id);
+				if (site != sites.end() && !ambiguous.count(id))
+				{
+					out.write(line.c_str(), begin - line.c_str());
+					out << site->second;
+				}
+				else
+				{
+					++unknown;
+					out << line;
+				}
+			}
+			else
+				out << line;
+			if (!in.eof())
+				out << '\n';
+		}
+		return unknown;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3 || argc > 4)
+	{
+		::std::cerr << "Usage: " << argv[0] << " <site table> <log> [expanded log]" << ::std::endl;
+		return 1;
+	}
+	::std::ifstream table(argv[1]);
+	if (!table)
+	{
+		::std::cerr << "Can't open: " << argv[1] << ::std::endl;
+		return 1;
+	}
+	::std::ifstream log(argv[2], ::std::ios::in | ::std::ios::binary);
+	if (!log)
+	{
+		::std::cerr << "Can't open: " << argv[2] << ::std::endl;
+		return 1;
+	}
+	::std::ofstream file;
+	if (argc == 4)
+	{
+		file.open(argv[3], ::std::ios::out | ::std::ios::binary | ::std::ios::trunc);
+		if (!file)
+		{
+			::std::cerr << "Can't open: " << argv[3] << ::std::endl;
+			return 1;
+		}
+	}
+	::std::unordered_map<::std::uint32_t, ::std::string> sites;
+	::std::unordered_set<::std::uint32_t> ambiguous;
+	const ::std::size_t malformed = readTable(table, sites, ambiguous);
+	if (malformed)
+		::std::cerr << "Malformed lines in site table: " << malformed << ::std::endl;
+	if (!ambiguous.empty())
+		::std::cerr << "Site identifiers with several headers in site table: " << ambiguous.size() << ::std::endl;
+	::std::ostream& out = argc == 4 ? file : ::std::cout;
+	const ::std::size_t unknown = expand(log, out, sites, ambiguous);
+	out << ::std::flush;
+	if (unknown)
+	{
+		::std::cerr << "Site identifiers not found in site table or ambiguous: " << unknown << ::std::endl;
+		return 2;
+	}
+	return 0;
+}